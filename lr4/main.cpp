@@ -12,11 +12,63 @@
 #include <map>
 #include <set>
 #include <queue>
+#include <deque>
 #include <functional>
+#include <array>
+#include <cmath>
+#include <numeric>
+#include <unordered_map>
+#include <tuple>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <memory>
 
 using namespace std;
 namespace fs = filesystem;
 
+// Счетчик выделений динамической памяти (для тестов производительности).
+// Включается при сборке с -DPIPELINE_COUNT_ALLOCATIONS: глобальный operator new
+// заменяется на подсчитывающий, а общий атомарный счетчик мешает параллельным
+// расчетам, поэтому в обычной сборке его нет. Операторы не встраиваются,
+// иначе GCC принимает free() для памяти из new за несоответствие new/delete.
+#ifdef PIPELINE_COUNT_ALLOCATIONS
+#if defined(__GNUC__)
+#define ALLOCATOR_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define ALLOCATOR_NOINLINE __declspec(noinline)
+#else
+#define ALLOCATOR_NOINLINE
+#endif
+
+static atomic<long long> heapAllocations(0);
+
+ALLOCATOR_NOINLINE void* operator new(size_t size) {
+    heapAllocations.fetch_add(1, memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+
+ALLOCATOR_NOINLINE void operator delete(void* p) noexcept {
+    free(p);
+}
+
+ALLOCATOR_NOINLINE void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+static long long heapAllocationCount() {
+    return heapAllocations.load(memory_order_relaxed);
+}
+#else
+static long long heapAllocationCount() {
+    return -1;  // подсчет выключен
+}
+#endif
+
 // Перечисление для типов соединений
 enum ConnectionType {
     STATION_TO_STATION,
@@ -114,6 +166,7 @@ struct CompressorStation {
     int totalWorkshops;
     int activeWorkshops;
     int stationClass;
+    double balance = 0;  // закачка газа в сеть (> 0) или отбор потребителям (< 0), усл. ед.
     
     // Метод для получения производительности КС
     double getCapacity() const {
@@ -131,987 +184,6266 @@ struct NetworkConnection {
     ConnectionType endType;
 };
 
-// Структура для графа (для алгоритмов поиска пути и потока)
-struct GraphEdge {
-    int to;          // ID конечной вершины
-    int pipeId;      // ID трубы
-    double capacity; // пропускная способность
-    double flow;     // текущий поток
-    double weight;   // вес ребра (для алгоритма Дейкстры)
-    int rev;         // индекс обратного ребра
-};
+// Индекс ID -> позиция объекта в векторе.
+// ID выдаются последовательно, а loadData отклоняет ID от DENSE_LIMIT,
+// поэтому хватает плотного массива с поиском за O(1).
+class IdIndex {
+public:
+    static constexpr int DENSE_LIMIT = 1 << 24;
 
-class Logger {
 private:
-    mutable ofstream logFile;
-    
+    vector<int> slots;  // slots[id] = позиция или -1
+
 public:
-    Logger() {
-        logFile.open("pipeline_log.txt", ios::app);
-        if (logFile.is_open()) {
-            auto now = chrono::system_clock::now();
-            auto time = chrono::system_clock::to_time_t(now);
-            logFile << "\n=== Сессия начата: " << ctime(&time);
+    void clear() {
+        slots.clear();
+    }
+    
+    // false - ID вне диапазона [0, DENSE_LIMIT), объект не проиндексирован
+    bool set(int id, int slot) {
+        if (id < 0 || id >= DENSE_LIMIT) return false;
+        size_t needed = static_cast<size_t>(id) + 1;
+        if (needed > slots.size()) {
+            slots.resize(max(needed, min<size_t>(slots.size() * 2, DENSE_LIMIT)), -1);
         }
+        slots[id] = slot;
+        return true;
     }
     
-    ~Logger() {
-        if (logFile.is_open()) {
-            auto now = chrono::system_clock::now();
-            auto time = chrono::system_clock::to_time_t(now);
-            logFile << "=== Сессия завершена: " << ctime(&time) << endl;
-            logFile.close();
+    void erase(int id) {
+        if (id >= 0 && id < static_cast<int>(slots.size())) {
+            slots[id] = -1;
         }
     }
     
-    void log(const string& action, const string& details = "") const {
-        if (logFile.is_open()) {
-            auto now = chrono::system_clock::now();
-            auto time = chrono::system_clock::to_time_t(now);
-            
-            char timeStr[20];
-            strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", localtime(&time));
-            
-            logFile << timeStr << " | " << action;
-            if (!details.empty()) {
-                logFile << " | " << details;
-            }
-            logFile << endl;
+    int find(int id) const {
+        if (id >= 0 && id < static_cast<int>(slots.size())) return slots[id];
+        return -1;
+    }
+    
+    // Переиндексация объектов начиная с позиции from (после erase или загрузки)
+    template <typename T>
+    void rebuild(const vector<T>& items, size_t from = 0) {
+        for (size_t i = from; i < items.size(); ++i) {
+            set(items[i].id, i);
         }
     }
 };
 
-class InputValidator {
-public:
-    static int getIntInput(const string& prompt, int min = numeric_limits<int>::min(),
-                          int max = numeric_limits<int>::max()) {
-        int value;
-        while (true) {
-            cout << prompt;
-            string input;
-            getline(cin, input);
-            
-            if (input.empty()) {
-                cout << "Ошибка: ввод не может быть пустым.\n";
-                continue;
-            }
-            
-            try {
-                value = stoi(input);
-                if (value < min || value > max) {
-                    cout << "Ошибка: значение должно быть от " << min << " до " << max << ".\n";
-                    continue;
-                }
-                break;
-            } catch (const exception&) {
-                cout << "Ошибка: пожалуйста, введите целое число.\n";
-            }
-        }
-        return value;
+// Ребро графа (для алгоритмов поиска пути и потока)
+struct GraphEdge {
+    int to;          // индекс конечной вершины
+    int pipeId;      // ID трубы
+    double capacity; // пропускная способность (0 для обратного ребра)
+    double weight;   // вес ребра (для алгоритма Дейкстры)
+    int rev;         // индекс парного ребра в общем массиве ребер
+    bool forward;    // true - прямое ребро трубы, false - обратное
+};
+
+// Описание ребра для построения графа (индексы вершин, pipeId = -1 для внутренних ребер)
+struct GraphArcSpec {
+    int from;
+    int to;
+    int pipeId;
+    double capacity;
+    double weight;
+};
+
+// Изменение сети, применяемое к графу без перестроения
+enum GraphDeltaType {
+    ARC_ADDED,    // труба подключена к сети
+    ARC_REMOVED,  // труба отключена от сети
+    ARC_UPDATED   // изменились пропускная способность или вес трубы
+};
+
+struct GraphDelta {
+    GraphDeltaType type;
+    int pipeId;
+    int startId;
+    int endId;
+    double capacity;
+    double weight;
+};
+
+// Постоянный граф сети в формате CSR (compressed sparse row).
+// Ребра вершины u лежат в arcs[arcBegin[u] .. arcEnd[u]), за ними до arcLimit[u] -
+// запас для добавления ребер. При исчерпании запаса блок вершины переносится
+// в конец массива с удвоенной емкостью, поэтому изменения стоят O(степени вершины).
+class NetworkGraph {
+private:
+    vector<int> nodeIds;               // индекс вершины -> ID объекта
+    unordered_map<int, int> idToNode;  // ID объекта -> индекс вершины (входной для разделенных КС)
+    vector<int> exitNodes;             // индекс вершины -> индекс выходной вершины (сама вершина, если не разделена)
+    vector<int> arcBegin;
+    vector<int> arcEnd;
+    vector<int> arcLimit;
+    vector<GraphEdge> arcs;
+    vector<int> pipeArcs;              // ID трубы -> индекс прямого ребра (-1, если трубы нет в графе)
+    bool split = false;                // КС разделены на входную и выходную вершины
+    long long version = -1;            // версия сети, по которой построен граф
+
+    static GraphEdge deadArc() {
+        return {-1, -1, 0.0, 0.0, -1, false};
     }
 
-    static double getDoubleInput(const string& prompt, double min = 0.0,
-                               double max = numeric_limits<double>::max()) {
-        double value;
-        while (true) {
-            cout << prompt;
-            string input;
-            getline(cin, input);
-            
-            if (input.empty()) {
-                cout << "Ошибка: ввод не может быть пустым.\n";
-                continue;
-            }
-            
-            try {
-                value = stod(input);
-                if (value < min || value > max) {
-                    cout << "Ошибка: значение должно быть от " << min << " до " << max << ".\n";
-                    continue;
-                }
-                break;
-            } catch (const exception&) {
-                cout << "Ошибка: пожалуйста, введите число.\n";
-            }
+    // Ребро переехало на позицию to: обновляем ссылки на него
+    void arcMoved(int to) {
+        arcs[arcs[to].rev].rev = to;
+        if (arcs[to].forward && arcs[to].pipeId >= 0) {
+            pipeArcs[arcs[to].pipeId] = to;
         }
-        return value;
     }
 
-    static string getStringInput(const string& prompt) {
-        string input;
-        while (true) {
-            cout << prompt;
-            getline(cin, input);
-            if (!input.empty()) {
-                break;
-            }
-            cout << "Ошибка: ввод не может быть пустым.\n";
-        }
-        return input;
+    // Новая вершина без ребер (только для неразделенного графа)
+    int addNode(int id) {
+        int u = nodeIds.size();
+        nodeIds.push_back(id);
+        idToNode[id] = u;
+        exitNodes.push_back(u);
+        arcBegin.push_back(arcs.size());
+        arcEnd.push_back(arcs.size());
+        arcLimit.push_back(arcs.size());
+        return u;
     }
 
-    static int getDiameterInput(const string& prompt) {
-        while (true) {
-            cout << prompt << " (500, 700, 1000, 1400 мм): ";
-            string input;
-            getline(cin, input);
-            
-            if (input.empty()) {
-                cout << "Ошибка: ввод не может быть пустым.\n";
-                continue;
-            }
-            
-            try {
-                int diameter = stoi(input);
-                for (const auto& cap : PIPE_CAPACITIES) {
-                    if (cap.diameter == diameter) {
-                        return diameter;
-                    }
-                }
-                cout << "Ошибка: допустимые диаметры: 500, 700, 1000, 1400 мм\n";
-            } catch (const exception&) {
-                cout << "Ошибка: пожалуйста, введите целое число.\n";
+    // Свободная позиция для нового ребра вершины u
+    int reserveArc(int u) {
+        if (arcEnd[u] == arcLimit[u]) {
+            int degree = arcEnd[u] - arcBegin[u];
+            int newBegin = arcs.size();
+            arcs.resize(arcs.size() + max(4, 2 * degree), deadArc());
+            for (int i = 0; i < degree; ++i) {
+                arcs[newBegin + i] = arcs[arcBegin[u] + i];
+                arcs[arcBegin[u] + i] = deadArc();
+                arcMoved(newBegin + i);
             }
+            arcBegin[u] = newBegin;
+            arcEnd[u] = newBegin + degree;
+            arcLimit[u] = arcs.size();
         }
+        return arcEnd[u]++;
     }
-};
-
-class PipelineSystem {
-private:
-    vector<Pipe> pipes;
-    vector<CompressorStation> stations;
-    vector<NetworkConnection> network;
-    int nextPipeId = 1;
-    int nextStationId = 1;
-    Logger logger;
 
-    int findPipeIndexById(int id) const {
-        auto it = find_if(pipes.begin(), pipes.end(),
-                         [id](const Pipe& p) { return p.id == id; });
-        return it != pipes.end() ? distance(pipes.begin(), it) : -1;
+    // Удаление ребра a вершины u: на его место переносится последнее ребро вершины
+    void removeArc(int u, int a) {
+        int last = arcEnd[u] - 1;
+        if (a != last) {
+            arcs[a] = arcs[last];
+            arcMoved(a);
+        }
+        arcs[last] = deadArc();
+        arcEnd[u]--;
     }
 
-    int findStationIndexById(int id) const {
-        auto it = find_if(stations.begin(), stations.end(),
-                         [id](const CompressorStation& s) { return s.id == id; });
-        return it != stations.end() ? distance(stations.begin(), it) : -1;
+    // Вершины - все объекты, участвующие в соединениях, упорядоченные по ID
+    void collectNodes(const vector<NetworkConnection>& network) {
+        nodeIds.clear();
+        for (const auto& conn : network) {
+            nodeIds.push_back(conn.startId);
+            nodeIds.push_back(conn.endId);
+        }
+        sort(nodeIds.begin(), nodeIds.end());
+        nodeIds.erase(unique(nodeIds.begin(), nodeIds.end()), nodeIds.end());
+        
+        idToNode.clear();
+        idToNode.reserve(nodeIds.size());
+        exitNodes.resize(nodeIds.size());
+        for (size_t i = 0; i < nodeIds.size(); ++i) {
+            idToNode[nodeIds[i]] = i;
+            exitNodes[i] = i;
+        }
     }
 
-    vector<int> parseIndicesFromInput(const string& input, const vector<int>& validIds) const {
-        if (input == "all" || input == "ALL") {
-            vector<int> allIndices;
-            for (int i = 0; i < validIds.size(); ++i) {
-                allIndices.push_back(i);
-            }
-            return allIndices;
+    // Заполнение CSR по списку ребер: прямое ребро у начала, обратное у конца
+    void assemble(const vector<GraphArcSpec>& specs) {
+        int n = nodeIds.size();
+        vector<int> offsets(n + 1, 0);
+        for (const auto& spec : specs) {
+            offsets[spec.from + 1]++;
+            offsets[spec.to + 1]++;
+        }
+        for (int i = 0; i < n; ++i) {
+            offsets[i + 1] += offsets[i];
         }
         
-        vector<int> indices;
-        stringstream ss(input);
-        string token;
-        
-        while (getline(ss, token, ',')) {
-            try {
-                int id = stoi(token);
-                auto it = find(validIds.begin(), validIds.end(), id);
-                if (it != validIds.end()) {
-                    indices.push_back(distance(validIds.begin(), it));
-                } else {
-                    cout << "Предупреждение: ID " << id << " не существует.\n";
-                }
-            } catch (const exception&) {
-                cout << "Предупреждение: '" << token << "' не является числом.\n";
+        arcs.assign(offsets[n], GraphEdge());
+        pipeArcs.clear();
+        arcBegin.assign(offsets.begin(), offsets.end() - 1);
+        arcEnd.assign(offsets.begin(), offsets.end() - 1);
+        for (const auto& spec : specs) {
+            int forwardIndex = arcEnd[spec.from]++;
+            int backwardIndex = arcEnd[spec.to]++;
+            
+            arcs[forwardIndex] = {spec.to, spec.pipeId, spec.capacity, spec.weight, backwardIndex, true};
+            arcs[backwardIndex] = {spec.from, spec.pipeId, 0.0, spec.weight, forwardIndex, false};
+            
+            if (spec.pipeId < 0) continue;
+            if (spec.pipeId >= static_cast<int>(pipeArcs.size())) {
+                pipeArcs.resize(spec.pipeId + 1, -1);
             }
+            pipeArcs[spec.pipeId] = forwardIndex;
         }
-        
-        sort(indices.begin(), indices.end());
-        indices.erase(unique(indices.begin(), indices.end()), indices.end());
-        return indices;
+        arcLimit = arcEnd;
     }
 
-    vector<int> selectMultipleObjects(const vector<int>& validIds, const string& objectType) const {
-        if (validIds.empty()) {
-            cout << "Нет доступных " << objectType << "!\n";
-            return {};
+public:
+    void build(const vector<NetworkConnection>& network, const vector<Pipe>& pipes,
+               const IdIndex& pipeIndex, long long networkVersion) {
+        collectNodes(network);
+        
+        vector<GraphArcSpec> specs;
+        specs.reserve(network.size());
+        for (const auto& conn : network) {
+            int pipeSlot = pipeIndex.find(conn.pipeId);
+            if (pipeSlot == -1) continue;
+            const Pipe& pipe = pipes[pipeSlot];
+            specs.push_back({idToNode[conn.startId], idToNode[conn.endId], conn.pipeId,
+                             pipe.getCapacity(), pipe.getWeight()});
         }
+        assemble(specs);
         
-        cout << "\nВыберите ID " << objectType << " через запятую или 'all' для всех: ";
-        string input;
-        getline(cin, input);
+        split = false;
+        version = networkVersion;
+    }
+    
+    // Граф с разделением КС на входную и выходную вершины, соединенные ребром
+    // с пропускной способностью станции (ограничение производительности КС)
+    void buildSplit(const vector<NetworkConnection>& network, const vector<Pipe>& pipes,
+                    const IdIndex& pipeIndex, const vector<CompressorStation>& stations,
+                    const IdIndex& stationIndex, long long networkVersion) {
+        collectNodes(network);
+        
+        vector<GraphArcSpec> specs;
+        specs.reserve(network.size() + nodeIds.size());
+        int n = nodeIds.size();
+        for (int u = 0; u < n; ++u) {
+            int stationSlot = stationIndex.find(nodeIds[u]);
+            if (stationSlot == -1) continue;
+            int out = nodeIds.size();
+            nodeIds.push_back(nodeIds[u]);
+            exitNodes.push_back(out);
+            exitNodes[u] = out;
+            specs.push_back({u, out, -1, stations[stationSlot].getCapacity(), 0.0});
+        }
         
-        return parseIndicesFromInput(input, validIds);
+        for (const auto& conn : network) {
+            int pipeSlot = pipeIndex.find(conn.pipeId);
+            if (pipeSlot == -1) continue;
+            const Pipe& pipe = pipes[pipeSlot];
+            specs.push_back({exitNodes[idToNode[conn.startId]], idToNode[conn.endId], conn.pipeId,
+                             pipe.getCapacity(), pipe.getWeight()});
+        }
+        assemble(specs);
+        
+        split = true;
+        version = networkVersion;
     }
-
-    vector<int> getPipeIds() const {
-        vector<int> ids;
-        for (const auto& pipe : pipes) {
-            ids.push_back(pipe.id);
+    
+    // Применение изменения сети за O(степени вершин). Возвращает false, если
+    // граф нужно перестроить целиком (новый объект в графе с разделенными КС).
+    bool applyDelta(const GraphDelta& delta, long long networkVersion) {
+        switch (delta.type) {
+            case ARC_UPDATED: {
+                int a = forwardArc(delta.pipeId);
+                if (a != -1) {
+                    arcs[a].capacity = delta.capacity;
+                    arcs[a].weight = delta.weight;
+                    arcs[arcs[a].rev].weight = delta.weight;
+                }
+                break;
+            }
+            case ARC_REMOVED: {
+                int a = forwardArc(delta.pipeId);
+                if (a != -1) {
+                    int r = arcs[a].rev;
+                    int u = arcs[r].to;
+                    int v = arcs[a].to;
+                    // Перестановки внутри блока u не затрагивают ребро r из блока v
+                    removeArc(u, a);
+                    removeArc(v, r);
+                    pipeArcs[delta.pipeId] = -1;
+                }
+                break;
+            }
+            case ARC_ADDED: {
+                int u = nodeIndex(delta.startId);
+                int v = nodeIndex(delta.endId);
+                if ((u == -1 || v == -1) && split) return false;
+                if (u == -1) u = addNode(delta.startId);
+                if (v == -1) v = addNode(delta.endId);
+                u = exitNodes[u];
+                
+                int forwardIndex = reserveArc(u);
+                int backwardIndex = reserveArc(v);
+                arcs[forwardIndex] = {v, delta.pipeId, delta.capacity, delta.weight, backwardIndex, true};
+                arcs[backwardIndex] = {u, delta.pipeId, 0.0, delta.weight, forwardIndex, false};
+                
+                if (delta.pipeId >= static_cast<int>(pipeArcs.size())) {
+                    pipeArcs.resize(delta.pipeId + 1, -1);
+                }
+                pipeArcs[delta.pipeId] = forwardIndex;
+                break;
+            }
         }
-        return ids;
+        version = networkVersion;
+        return true;
     }
-
-    vector<int> getStationIds() const {
-        vector<int> ids;
-        for (const auto& station : stations) {
-            ids.push_back(station.id);
+    
+    // Изменение производительности разделенной КС за O(степени вершины)
+    void updateStationCapacity(int stationId, double capacity) {
+        int u = nodeIndex(stationId);
+        if (u == -1 || exitNodes[u] == u) return;
+        for (int a = arcBegin[u]; a < arcEnd[u]; ++a) {
+            if (arcs[a].forward && arcs[a].pipeId < 0) {
+                arcs[a].capacity = capacity;
+                return;
+            }
         }
-        return ids;
     }
-
-    static string toLower(const string& str) {
-        string result = str;
-        transform(result.begin(), result.end(), result.begin(), ::tolower);
-        return result;
+    
+    long long getVersion() const { return version; }
+    
+    // Граф устарел и будет перестроен при следующем запросе
+    void invalidate() { version = -1; }
+    
+    int nodeCount() const { return nodeIds.size(); }
+    int arcCount() const { return arcs.size(); }
+    
+    int nodeIndex(int id) const {
+        auto it = idToNode.find(id);
+        return it != idToNode.end() ? it->second : -1;
     }
-
-    double calculateInactivePercent(const CompressorStation& station) const {
-        return station.totalWorkshops > 0 ?
-               100.0 * (station.totalWorkshops - station.activeWorkshops) / station.totalWorkshops : 0.0;
+    
+    int nodeId(int index) const { return nodeIds[index]; }
+    int exitNode(int index) const { return exitNodes[index]; }
+    
+    // Вершина без ребер: объект отключен от сети изменениями (ARC_REMOVED).
+    // Перестроение такую вершину не создает, поэтому анализ ее пропускает
+    bool isDetached(int u) const { return arcBegin[u] == arcEnd[u]; }
+    int arcsBegin(int u) const { return arcBegin[u]; }
+    int arcsEnd(int u) const { return arcEnd[u]; }
+    const GraphEdge& arc(int index) const { return arcs[index]; }
+    int tail(int index) const { return arcs[arcs[index].rev].to; }
+    
+    // Пропускная способность трубы ребра независимо от направления обхода
+    double pipeCapacity(int index) const {
+        const GraphEdge& edge = arcs[index];
+        return edge.forward ? edge.capacity : arcs[edge.rev].capacity;
     }
-
-    vector<int> findPipesByName(const string& searchName) const {
-        vector<int> result;
-        string searchLower = toLower(searchName);
-        
-        for (size_t i = 0; i < pipes.size(); ++i) {
-            if (toLower(pipes[i].name).find(searchLower) != string::npos) {
-                result.push_back(i);
-            }
-        }
-        return result;
+    
+    // Верхняя граница ID труб в графе (для плотных массивов по ID трубы)
+    int pipeIdLimit() const { return pipeArcs.size(); }
+    
+    int forwardArc(int pipeId) const {
+        return pipeId >= 0 && pipeId < static_cast<int>(pipeArcs.size()) ? pipeArcs[pipeId] : -1;
     }
-
-    vector<int> findPipesByRepairStatus(bool repairStatus) const {
-        vector<int> result;
-        for (size_t i = 0; i < pipes.size(); ++i) {
-            if (pipes[i].underRepair == repairStatus) {
-                result.push_back(i);
-            }
+    
+    // Вспомогательная вершина вне сети (сверхисточник или сверхсток) с ID,
+    // не совпадающим с объектами; не разделяется, ребра добавляются через applyDelta
+    int addAuxiliaryNode(int id) {
+        return addNode(id);
+    }
+    
+    // Неориентированное представление: обратное ребро трубы получает ту же
+    // пропускную способность, что и прямое (поток по трубе в любую сторону)
+    void makeUndirected() {
+        for (auto& e : arcs) {
+            if (e.forward && e.pipeId >= 0) arcs[e.rev].capacity = e.capacity;
         }
-        return result;
     }
+};
 
-    vector<int> findStationsByName(const string& searchName) const {
-        vector<int> result;
-        string searchLower = toLower(searchName);
+// Алгоритмы расчета максимального потока
+enum MaxFlowAlgorithm {
+    EDMONDS_KARP,
+    DINIC,
+    PUSH_RELABEL
+};
+
+// Путь из разложения потока: объекты от источника к стоку и трубы между ними
+struct FlowPath {
+    double amount;
+    vector<int> nodeIds;
+    vector<int> pipeIds;
+};
+
+// Минимальный разрез s-t: трубы разреза и разбиение вершин на две доли
+struct MinCutResult {
+    double capacity = 0;       // суммарная пропускная способность разреза (= макс. поток)
+    vector<int> pipeIds;       // трубы, идущие из доли источника в долю стока
+    vector<int> stationIds;    // КС, производительность которых входит в разрез
+    vector<int> sourceSideIds; // ID объектов, достижимых из источника в остаточной сети
+    vector<int> sinkSideIds;   // ID остальных объектов графа
+};
+
+// Результат расчета максимального потока
+struct MaxFlowResult {
+    double value = 0;         // величина потока
+    vector<double> arcFlow;   // поток по каждому ребру графа (обратные ребра - с минусом)
+    vector<double> pipeFlow;  // поток по трубе, индекс - ID трубы
+    vector<FlowPath> paths;   // разложение на пути (заполняется по запросу)
+};
+
+// Расчет максимального потока на плоском графе NetworkGraph.
+// Поток хранится в отдельном массиве, граф не изменяется.
+class MaxFlowSolver {
+private:
+    static constexpr double EPS = 1e-9;
+    
+    const NetworkGraph& g;
+    int n;
+    int source;
+    int sink;
+    vector<double> flow;
+    
+    double residual(int a) const {
+        return g.arc(a).capacity - flow[a];
+    }
+    
+    void push(int a, double amount) {
+        flow[a] += amount;
+        flow[g.arc(a).rev] -= amount;
+    }
+    
+    int tail(int a) const {
+        return g.arc(g.arc(a).rev).to;
+    }
+    
+    // Эдмондс-Карп: кратчайшие по числу ребер увеличивающие пути (BFS)
+    double edmondsKarp() {
+        double total = 0;
+        vector<int> parentArc(n);
+        vector<int> q(n);
         
-        for (size_t i = 0; i < stations.size(); ++i) {
-            if (toLower(stations[i].name).find(searchLower) != string::npos) {
-                result.push_back(i);
+        while (true) {
+            fill(parentArc.begin(), parentArc.end(), -1);
+            parentArc[source] = -2;
+            int head = 0, tailPos = 0;
+            q[tailPos++] = source;
+            
+            while (head < tailPos && parentArc[sink] == -1) {
+                int u = q[head++];
+                for (int a = g.arcsBegin(u); a < g.arcsEnd(u); ++a) {
+                    int v = g.arc(a).to;
+                    if (parentArc[v] == -1 && residual(a) > EPS) {
+                        parentArc[v] = a;
+                        q[tailPos++] = v;
+                    }
+                }
+            }
+            
+            if (parentArc[sink] == -1) break;
+            
+            double pathFlow = numeric_limits<double>::infinity();
+            for (int v = sink; v != source; v = tail(parentArc[v])) {
+                pathFlow = min(pathFlow, residual(parentArc[v]));
             }
+            for (int v = sink; v != source; v = tail(parentArc[v])) {
+                push(parentArc[v], pathFlow);
+            }
+            total += pathFlow;
         }
-        return result;
+        return total;
     }
-
-    vector<int> findStationsByInactivePercent(double targetPercent, int comparisonType) const {
-        vector<int> result;
-        for (size_t i = 0; i < stations.size(); ++i) {
-            double inactivePercent = calculateInactivePercent(stations[i]);
-            bool match = false;
+    
+    // Диниц: слоистая сеть (BFS) + блокирующий поток (итеративный DFS)
+    double dinic() {
+        double total = 0;
+        vector<int> level(n);
+        vector<int> current(n);
+        vector<int> q(n);
+        vector<int> path;
+        
+        while (true) {
+            // Построение слоистой сети
+            fill(level.begin(), level.end(), -1);
+            level[source] = 0;
+            int head = 0, tailPos = 0;
+            q[tailPos++] = source;
+            while (head < tailPos) {
+                int u = q[head++];
+                for (int a = g.arcsBegin(u); a < g.arcsEnd(u); ++a) {
+                    int v = g.arc(a).to;
+                    if (level[v] == -1 && residual(a) > EPS) {
+                        level[v] = level[u] + 1;
+                        q[tailPos++] = v;
+                    }
+                }
+            }
+            if (level[sink] == -1) break;
             
-            switch (comparisonType) {
-                case 1: match = (inactivePercent > targetPercent); break;
-                case 2: match = (inactivePercent < targetPercent); break;
-                case 3: match = (abs(inactivePercent - targetPercent) < 0.01); break;
+            for (int u = 0; u < n; ++u) {
+                current[u] = g.arcsBegin(u);
             }
             
-            if (match) {
-                result.push_back(i);
+            // Блокирующий поток: продвижение по текущим ребрам без рекурсии
+            path.clear();
+            int u = source;
+            while (true) {
+                if (u == sink) {
+                    double pathFlow = numeric_limits<double>::infinity();
+                    for (int a : path) {
+                        pathFlow = min(pathFlow, residual(a));
+                    }
+                    for (int a : path) {
+                        push(a, pathFlow);
+                    }
+                    total += pathFlow;
+                    
+                    // Откат к началу первого насыщенного ребра
+                    size_t k = 0;
+                    while (k < path.size() && residual(path[k]) > EPS) ++k;
+                    u = tail(path[k]);
+                    path.resize(k);
+                    continue;
+                }
+                
+                int& a = current[u];
+                while (a < g.arcsEnd(u) &&
+                       (residual(a) <= EPS || level[g.arc(a).to] != level[u] + 1)) {
+                    ++a;
+                }
+                
+                if (a < g.arcsEnd(u)) {
+                    path.push_back(a);
+                    u = g.arc(a).to;
+                } else {
+                    // Тупик: вершина исключается из слоистой сети
+                    level[u] = -1;
+                    if (path.empty()) break;
+                    u = tail(path.back());
+                    path.pop_back();
+                    ++current[u];
+                }
             }
         }
-        return result;
+        return total;
     }
-
-    void displayObjects(const vector<int>& pipeIndices, const vector<int>& stationIndices) const {
-        if (pipeIndices.empty() && stationIndices.empty()) {
-            cout << "Нет объектов для отображения.\n";
-            return;
+    
+    // Проталкивание предпотока с выбором вершины наибольшей высоты,
+    // эвристиками разрыва (gap) и глобальной перемаркировки (global relabel)
+    double pushRelabel() {
+        vector<int> height(n, 0);
+        vector<double> excess(n, 0.0);
+        vector<int> current(n);
+        
+        // Активные вершины по высотам (высота не превышает 2n)
+        int maxHeight = 2 * n + 1;
+        vector<vector<int>> active(maxHeight + 1);
+        int highest = 0;
+        
+        // Списки всех вершин с высотой < n (для эвристики разрыва)
+        vector<int> bucketHead(n, -1), nextInBucket(n, -1), prevInBucket(n, -1);
+        vector<int> bfsQueue(n);
+        
+        auto bucketRemove = [&](int v) {
+            int h = height[v];
+            if (h >= n) return;
+            if (prevInBucket[v] != -1) nextInBucket[prevInBucket[v]] = nextInBucket[v];
+            else bucketHead[h] = nextInBucket[v];
+            if (nextInBucket[v] != -1) prevInBucket[nextInBucket[v]] = prevInBucket[v];
+        };
+        auto bucketInsert = [&](int v) {
+            int h = height[v];
+            if (h >= n) return;
+            prevInBucket[v] = -1;
+            nextInBucket[v] = bucketHead[h];
+            if (bucketHead[h] != -1) prevInBucket[bucketHead[h]] = v;
+            bucketHead[h] = v;
+        };
+        auto activate = [&](int v) {
+            if (v != source && v != sink) {
+                active[height[v]].push_back(v);
+                highest = max(highest, height[v]);
+            }
+        };
+        
+        // Глобальная перемаркировка: точные расстояния до стока (или до источника + n)
+        auto globalRelabel = [&]() {
+            fill(bucketHead.begin(), bucketHead.end(), -1);
+            for (auto& bucket : active) bucket.clear();
+            highest = 0;
+            
+            // Сначала BFS от стока, затем от источника (высота источника всегда n)
+            vector<bool> seen(n, false);
+            seen[source] = true;
+            seen[sink] = true;
+            height[source] = n;
+            height[sink] = 0;
+            for (int root : {sink, source}) {
+                int head = 0, tailPos = 0;
+                bfsQueue[tailPos++] = root;
+                while (head < tailPos) {
+                    int v = bfsQueue[head++];
+                    for (int a = g.arcsBegin(v); a < g.arcsEnd(v); ++a) {
+                        // Ребро u -> v с остаточной пропускной способностью
+                        int r = g.arc(a).rev;
+                        int u = g.arc(a).to;
+                        if (!seen[u] && residual(r) > EPS) {
+                            seen[u] = true;
+                            height[u] = height[v] + 1;
+                            bfsQueue[tailPos++] = u;
+                        }
+                    }
+                }
+            }
+            for (int v = 0; v < n; ++v) {
+                if (!seen[v]) height[v] = maxHeight;
+                current[v] = g.arcsBegin(v);
+                bucketInsert(v);
+                if (excess[v] > EPS && height[v] < maxHeight) activate(v);
+            }
+        };
+        
+        // Насыщение всех ребер из источника
+        for (int a = g.arcsBegin(source); a < g.arcsEnd(source); ++a) {
+            double amount = residual(a);
+            if (amount > EPS) {
+                push(a, amount);
+                excess[g.arc(a).to] += amount;
+                excess[source] -= amount;
+            }
         }
+        globalRelabel();
         
-        if (!pipeIndices.empty()) {
-            cout << "\nТрубы (" << pipeIndices.size() << ")\n";
-            cout << "ID | Название | Длина | Диаметр | В ремонте | В сети | Начало -> Конец | Произв.\n";
-            cout << string(90, '-') << endl;
-            for (int index : pipeIndices) {
-                const Pipe& pipe = pipes[index];
-                cout << setw(3) << pipe.id << " | "
-                     << setw(10) << left << (pipe.name.length() > 10 ? pipe.name.substr(0, 7) + "..." : pipe.name) << " | "
-                     << setw(6) << fixed << setprecision(2) << pipe.length << " | "
-                     << setw(7) << pipe.diameter << " | "
-                     << setw(10) << (pipe.underRepair ? "Да" : "Нет") << " | "
-                     << setw(6) << (pipe.inUse ? "Да" : "Нет") << " | ";
-                
-                if (pipe.inUse) {
-                    string startStr, endStr;
-                    
-                    if (pipe.startType == STATION_TO_STATION || pipe.startType == STATION_TO_PIPE) {
-                        startStr = "КС" + to_string(pipe.startId);
-                    } else {
-                        startStr = "Тр" + to_string(pipe.startId);
+        long long work = 0;
+        long long relabelPeriod = 6LL * n + g.arcCount();
+        
+        while (true) {
+            while (highest >= 0 && active[highest].empty()) --highest;
+            if (highest < 0) break;
+            
+            int u = active[highest].back();
+            active[highest].pop_back();
+            if (height[u] != highest || excess[u] <= EPS) continue;
+            
+            // Разрядка вершины u
+            while (excess[u] > EPS) {
+                if (current[u] == g.arcsEnd(u)) {
+                    // Перемаркировка
+                    int oldHeight = height[u];
+                    int newHeight = maxHeight;
+                    for (int a = g.arcsBegin(u); a < g.arcsEnd(u); ++a) {
+                        if (residual(a) > EPS) {
+                            newHeight = min(newHeight, height[g.arc(a).to] + 1);
+                        }
                     }
+                    work += g.arcsEnd(u) - g.arcsBegin(u) + 12;
                     
-                    if (pipe.endType == STATION_TO_STATION || pipe.endType == PIPE_TO_STATION) {
-                        endStr = "КС" + to_string(pipe.endId);
-                    } else {
-                        endStr = "Тр" + to_string(pipe.endId);
+                    bucketRemove(u);
+                    if (oldHeight < n && bucketHead[oldHeight] == -1) {
+                        // Разрыв: вершины выше oldHeight больше не достигают стока
+                        for (int h = oldHeight + 1; h < n; ++h) {
+                            for (int v = bucketHead[h]; v != -1; v = nextInBucket[v]) {
+                                height[v] = n + 1;
+                                current[v] = g.arcsBegin(v);
+                                if (excess[v] > EPS) activate(v);
+                            }
+                            bucketHead[h] = -1;
+                        }
+                        newHeight = max(newHeight, n + 1);
                     }
-                    
-                    cout << setw(5) << startStr << " -> " << setw(5) << endStr << " | ";
-                } else {
-                    cout << "Не подключена            | ";
+                    height[u] = newHeight;
+                    current[u] = g.arcsBegin(u);
+                    bucketInsert(u);
+                    if (newHeight >= maxHeight) break;
+                    continue;
                 }
                 
-                cout << setw(8) << fixed << setprecision(1) << pipe.getCapacity() << endl;
+                int a = current[u];
+                int v = g.arc(a).to;
+                if (residual(a) > EPS && height[u] == height[v] + 1) {
+                    double amount = min(excess[u], residual(a));
+                    bool wasInactive = excess[v] <= EPS;
+                    push(a, amount);
+                    excess[u] -= amount;
+                    excess[v] += amount;
+                    if (wasInactive) activate(v);
+                } else {
+                    ++current[u];
+                }
             }
-        }
-
-        if (!stationIndices.empty()) {
-            cout << "\nКС (" << stationIndices.size() << ")\n";
-            cout << "ID | Название | Всего цехов | Работает | Незадействовано | Класс | Произв.\n";
-            cout << string(80, '-') << endl;
-            for (int index : stationIndices) {
-                const CompressorStation& station = stations[index];
-                double inactivePercent = calculateInactivePercent(station);
-                cout << setw(3) << station.id << " | "
-                     << setw(10) << left << (station.name.length() > 10 ? station.name.substr(0, 7) + "..." : station.name) << " | "
-                     << setw(12) << station.totalWorkshops << " | "
-                     << setw(9) << station.activeWorkshops << " | "
-                     << setw(15) << fixed << setprecision(1) << inactivePercent << "% | "
-                     << setw(5) << station.stationClass << " | "
-                     << setw(8) << fixed << setprecision(1) << station.getCapacity() << endl;
+            
+            if (excess[u] > EPS && height[u] < maxHeight) activate(u);
+            
+            if (work > relabelPeriod) {
+                work = 0;
+                globalRelabel();
             }
         }
+        
+        return excess[sink];
     }
 
-    // Поиск свободной трубы по диаметру
-    int findAvailablePipeByDiameter(int diameter) const {
-        for (size_t i = 0; i < pipes.size(); ++i) {
-            if (pipes[i].diameter == diameter && !pipes[i].inUse && !pipes[i].underRepair) {
-                return i;
+public:
+    MaxFlowSolver(const NetworkGraph& graph, int sourceIndex, int sinkIndex)
+        : g(graph), n(graph.nodeCount()), source(sourceIndex), sink(sinkIndex) {}
+    
+    MaxFlowResult run(MaxFlowAlgorithm algorithm, bool withPaths = false) {
+        flow.assign(g.arcCount(), 0.0);
+        MaxFlowResult result;
+        
+        if (source != sink) {
+            switch (algorithm) {
+                case EDMONDS_KARP: result.value = edmondsKarp(); break;
+                case DINIC: result.value = dinic(); break;
+                case PUSH_RELABEL: result.value = pushRelabel(); break;
             }
         }
-        return -1;
-    }
-
-    // Получение типа объекта по ID
-    pair<bool, int> getObjectInfo(int id) const {
-        // Проверяем, является ли ID станцией
-        int stationIndex = findStationIndexById(id);
-        if (stationIndex != -1) {
-            return {true, stationIndex}; // true = станция
-        }
         
-        // Проверяем, является ли ID трубой
-        int pipeIndex = findPipeIndexById(id);
-        if (pipeIndex != -1) {
-            return {false, pipeIndex}; // false = труба
+        result.pipeFlow = pipeFlows(g, flow);
+        if (withPaths && source != sink) {
+            result.paths = decompose(g, source, sink, flow);
         }
-        
-        return {false, -1}; // не найдено
-    }
-
-    // Определение типа соединения
-    ConnectionType determineConnectionType(bool isStartStation, bool isEndStation) {
-        if (isStartStation && isEndStation) return STATION_TO_STATION;
-        if (!isStartStation && !isEndStation) return PIPE_TO_PIPE;
-        if (isStartStation && !isEndStation) return STATION_TO_PIPE;
-        return PIPE_TO_STATION;
+        result.arcFlow = move(flow);
+        return result;
     }
-
-    // Проверка возможности соединения
-    bool canConnectObjects(int startId, int endId, int diameter) {
-        if (startId == endId) {
-            cout << "Ошибка: нельзя соединить объект с самим собой!\n";
-            return false;
+    
+    // Дорасчет от предыдущего потока по трубам (индекс - ID трубы) после изменения
+    // пропускных способностей: превышения снимаются, возникший дисбаланс вершин
+    // гасится вдоль путей с потоком, затем поток снова увеличивается алгоритмом Диница
+    MaxFlowResult warmStart(const vector<double>& previousPipeFlow, bool withPaths = false) {
+        flow.assign(g.arcCount(), 0.0);
+        MaxFlowResult result;
+        if (source == sink) {
+            result.pipeFlow = pipeFlows(g, flow);
+            result.arcFlow = move(flow);
+            return result;
         }
         
-        // Получаем информацию об объектах
-        auto [isStartStation, startIndex] = getObjectInfo(startId);
-        auto [isEndStation, endIndex] = getObjectInfo(endId);
-        
-        if (startIndex == -1) {
-            cout << "Ошибка: объект с ID " << startId << " не существует!\n";
-            return false;
+        int limit = min<int>(previousPipeFlow.size(), g.pipeIdLimit());
+        for (int pipeId = 0; pipeId < limit; ++pipeId) {
+            int a = g.forwardArc(pipeId);
+            if (a != -1 && previousPipeFlow[pipeId] > EPS) push(a, previousPipeFlow[pipeId]);
         }
         
-        if (endIndex == -1) {
-            cout << "Ошибка: объект с ID " << endId << " не существует!\n";
-            return false;
+        // Ребра разделенных КС: поток через КС равен притоку во входную вершину
+        // (для источника - оттоку из выходной вершины)
+        for (int u = 0; u < n; ++u) {
+            int out = g.exitNode(u);
+            if (out == u) continue;
+            int stationArc = -1;
+            double inflow = 0;
+            for (int a = g.arcsBegin(u); a < g.arcsEnd(u); ++a) {
+                if (g.arc(a).pipeId < 0) stationArc = a;
+                else inflow -= flow[a];
+            }
+            if (u == source) {
+                inflow = 0;
+                for (int a = g.arcsBegin(out); a < g.arcsEnd(out); ++a) {
+                    if (g.arc(a).pipeId >= 0) inflow += flow[a];
+                }
+            }
+            if (stationArc != -1) push(stationArc, inflow);
         }
         
-        // Проверка для труб
-        if (!isStartStation) {
-            const Pipe& startPipe = pipes[startIndex];
-            if (startPipe.underRepair) {
-                cout << "Ошибка: труба " << startId << " в ремонте!\n";
-                return false;
+        // Снятие превышений пропускной способности
+        for (int u = 0; u < n; ++u) {
+            for (int a = g.arcsBegin(u); a < g.arcsEnd(u); ++a) {
+                double over = -residual(a);
+                if (g.arc(a).forward && over > EPS) push(a, -over);
             }
         }
         
-        if (!isEndStation) {
-            const Pipe& endPipe = pipes[endIndex];
-            if (endPipe.underRepair) {
-                cout << "Ошибка: труба " << endId << " в ремонте!\n";
-                return false;
-            }
+        // Баланс вершины: отток минус приток
+        vector<double> balance(n, 0.0);
+        for (int u = 0; u < n; ++u) {
+            for (int a = g.arcsBegin(u); a < g.arcsEnd(u); ++a) balance[u] += flow[a];
         }
         
-        // Проверка на существующее соединение (в одну сторону)
-        for (const auto& conn : network) {
-            if (conn.startId == startId && conn.endId == endId) {
-                cout << "Ошибка: соединение между этими объектами уже существует!\n";
-                return false;
+        vector<int> parentArc(n, -1);
+        vector<int> visited;
+        
+        // Поиск пути по ребрам с потоком: назад (к источнику или вершине с недостатком
+        // притока) или вперед (к стоку или вершине с избытком притока)
+        auto findPath = [&](int start, bool backward) {
+            int found = -1;
+            visited.assign(1, start);
+            parentArc[start] = -2;
+            for (size_t head = 0; head < visited.size() && found == -1; ++head) {
+                int x = visited[head];
+                for (int a = g.arcsBegin(x); a < g.arcsEnd(x); ++a) {
+                    int y = g.arc(a).to;
+                    bool carries = backward ? flow[a] < -EPS : flow[a] > EPS;
+                    if (!carries || parentArc[y] != -1) continue;
+                    parentArc[y] = a;
+                    visited.push_back(y);
+                    bool target = backward ? (y == source || (y != sink && balance[y] > EPS))
+                                           : (y == sink || (y != source && balance[y] < -EPS));
+                    if (target) {
+                        found = y;
+                        break;
+                    }
+                }
+            }
+            return found;
+        };
+        
+        // Уменьшение потока на пути start <- ... <- end (amount вдоль найденных ребер)
+        auto cancelAlongPath = [&](int start, int end, double amount, bool backward) {
+            for (int y = end; y != start; y = g.arc(g.arc(parentArc[y]).rev).to) {
+                push(parentArc[y], backward ? amount : -amount);
+            }
+            balance[start] += backward ? amount : -amount;
+            balance[end] -= backward ? amount : -amount;
+        };
+        
+        auto pathCapacity = [&](int start, int end, bool backward) {
+            double amount = numeric_limits<double>::infinity();
+            for (int y = end; y != start; y = g.arc(g.arc(parentArc[y]).rev).to) {
+                amount = min(amount, backward ? -flow[parentArc[y]] : flow[parentArc[y]]);
+            }
+            if (end != source && end != sink) amount = min(amount, fabs(balance[end]));
+            return amount;
+        };
+        
+        for (int pass = 0; pass < 2; ++pass) {
+            bool backward = pass == 0;
+            for (int u = 0; u < n; ++u) {
+                if (u == source || u == sink) continue;
+                while (backward ? balance[u] < -EPS : balance[u] > EPS) {
+                    int end = findPath(u, backward);
+                    if (end != -1) {
+                        double amount = min(fabs(balance[u]), pathCapacity(u, end, backward));
+                        cancelAlongPath(u, end, amount, backward);
+                    }
+                    for (int x : visited) parentArc[x] = -1;
+                    if (end == -1) break;
+                }
             }
         }
         
-        // Проверка диаметра для соединения труб с трубами
-        if (!isStartStation && !isEndStation) {
-            const Pipe& startPipe = pipes[startIndex];
-            const Pipe& endPipe = pipes[endIndex];
-            
-            if (startPipe.diameter != diameter || endPipe.diameter != diameter) {
-                cout << "Ошибка: диаметр соединяющей трубы должен совпадать с диаметром соединяемых труб!\n";
-                cout << "Диаметр трубы " << startId << ": " << startPipe.diameter << " мм\n";
-                cout << "Диаметр трубы " << endId << ": " << endPipe.diameter << " мм\n";
-                cout << "Диаметр соединяющей трубы: " << diameter << " мм\n";
-                return false;
+        result.value = balance[source] + dinic();
+        result.pipeFlow = pipeFlows(g, flow);
+        if (withPaths) {
+            result.paths = decompose(g, source, sink, flow);
+        }
+        result.arcFlow = move(flow);
+        return result;
+    }
+    
+    // Поток по трубам из потока по ребрам: плотный массив по ID трубы
+    static vector<double> pipeFlows(const NetworkGraph& g, const vector<double>& arcFlow) {
+        vector<double> result(g.pipeIdLimit(), 0.0);
+        for (int pipeId = 0; pipeId < g.pipeIdLimit(); ++pipeId) {
+            int a = g.forwardArc(pipeId);
+            if (a != -1) result[pipeId] = arcFlow[a];
+        }
+        return result;
+    }
+    
+    // Минимальный разрез по достижимости из источника в остаточной сети, O(V + E)
+    static MinCutResult minCut(const NetworkGraph& g, int source, const vector<double>& arcFlow) {
+        int n = g.nodeCount();
+        MinCutResult cut;
+        if (source < 0 || source >= n) return cut;
+        
+        vector<bool> reachable(n, false);
+        vector<int> q;
+        q.reserve(n);
+        q.push_back(source);
+        reachable[source] = true;
+        for (size_t head = 0; head < q.size(); ++head) {
+            int u = q[head];
+            for (int a = g.arcsBegin(u); a < g.arcsEnd(u); ++a) {
+                int v = g.arc(a).to;
+                if (!reachable[v] && g.arc(a).capacity - arcFlow[a] > EPS) {
+                    reachable[v] = true;
+                    q.push_back(v);
+                }
+            }
+        }
+        
+        for (int u = 0; u < n; ++u) {
+            // Разделенная КС относится к доле своей входной вершины
+            if (g.nodeIndex(g.nodeId(u)) == u) {
+                (reachable[u] ? cut.sourceSideIds : cut.sinkSideIds).push_back(g.nodeId(u));
+            }
+            if (!reachable[u]) continue;
+            for (int a = g.arcsBegin(u); a < g.arcsEnd(u); ++a) {
+                const GraphEdge& edge = g.arc(a);
+                if (edge.forward && !reachable[edge.to] && edge.capacity > 0) {
+                    if (edge.pipeId >= 0) cut.pipeIds.push_back(edge.pipeId);
+                    else cut.stationIds.push_back(g.nodeId(u));
+                    cut.capacity += edge.capacity;
+                }
+            }
+        }
+        return cut;
+    }
+    
+    // Разложение потока на пути источник -> сток за O(E * число путей).
+    // Указатели текущих ребер не возвращаются назад, циклы потока сокращаются по ходу.
+    static vector<FlowPath> decompose(const NetworkGraph& g, int source, int sink, const vector<double>& arcFlow) {
+        int n = g.nodeCount();
+        vector<double> remaining(g.arcCount(), 0.0);
+        for (int a = 0; a < g.arcCount(); ++a) {
+            if (g.arc(a).forward && arcFlow[a] > EPS) remaining[a] = arcFlow[a];
+        }
+        
+        vector<int> current(n);
+        for (int u = 0; u < n; ++u) current[u] = g.arcsBegin(u);
+        vector<int> positionInPath(n, -1);
+        vector<int> pathArcs;
+        vector<FlowPath> paths;
+        
+        auto cancel = [&](size_t from) {
+            double amount = numeric_limits<double>::infinity();
+            for (size_t i = from; i < pathArcs.size(); ++i) amount = min(amount, remaining[pathArcs[i]]);
+            for (size_t i = from; i < pathArcs.size(); ++i) remaining[pathArcs[i]] -= amount;
+            return amount;
+        };
+        auto unwindTo = [&](size_t length) {
+            while (pathArcs.size() > length) {
+                positionInPath[g.arc(pathArcs.back()).to] = -1;
+                pathArcs.pop_back();
+            }
+        };
+        
+        int u = source;
+        positionInPath[source] = 0;
+        while (true) {
+            if (u == sink) {
+                FlowPath path;
+                path.amount = cancel(0);
+                path.nodeIds.push_back(g.nodeId(source));
+                for (int a : pathArcs) {
+                    // Внутреннее ребро разделенной КС не добавляет нового объекта
+                    if (g.arc(a).pipeId < 0) continue;
+                    path.pipeIds.push_back(g.arc(a).pipeId);
+                    path.nodeIds.push_back(g.nodeId(g.arc(a).to));
+                }
+                paths.push_back(move(path));
+                unwindTo(0);
+                u = source;
+                continue;
+            }
+            
+            int& a = current[u];
+            while (a < g.arcsEnd(u) && remaining[a] <= EPS) ++a;
+            
+            if (a == g.arcsEnd(u)) {
+                // Остаток потока из-за погрешности: отбрасываем входящее ребро
+                if (pathArcs.empty()) break;
+                remaining[pathArcs.back()] = 0;
+                positionInPath[u] = -1;
+                pathArcs.pop_back();
+                u = pathArcs.empty() ? source : g.arc(pathArcs.back()).to;
+                continue;
+            }
+            
+            int v = g.arc(a).to;
+            pathArcs.push_back(a);
+            if (positionInPath[v] != -1) {
+                // Цикл потока: вычитаем его и возвращаемся в v
+                size_t start = positionInPath[v];
+                cancel(start);
+                pathArcs.pop_back();
+                unwindTo(start);
+                u = v;
+            } else {
+                positionInPath[v] = pathArcs.size();
+                u = v;
+            }
+        }
+        
+        return paths;
+    }
+};
+
+// Алгоритмы поиска кратчайшего пути
+enum ShortestPathAlgorithm {
+    DIJKSTRA,
+    BIDIRECTIONAL_DIJKSTRA,
+    ALT_ASTAR,
+    CONTRACTION_HIERARCHY,
+    CUSTOMIZABLE_HIERARCHY
+};
+
+// Результат поиска кратчайшего пути
+struct ShortestPathResult {
+    double distance = numeric_limits<double>::infinity();
+    vector<int> nodes;  // индексы вершин пути от начала к концу
+    vector<int> arcs;   // индексы ребер пути
+    int settled = 0;    // число окончательно обработанных вершин
+};
+
+// Дерево кратчайших путей от корня: расстояния и ребро от родителя к вершине
+// (-1 у корня и недостижимых вершин)
+struct ShortestPathTree {
+    vector<double> dist;
+    vector<int> parentArc;
+};
+
+// Пара путей без общих труб с минимальной суммарной длиной
+struct DisjointPathPair {
+    double totalLength = numeric_limits<double>::infinity();  // бесконечность - пары нет
+    ShortestPathResult paths[2];  // paths[0] не длиннее paths[1]; без пары paths[0] - кратчайший путь
+    int settled = 0;    // число окончательно обработанных вершин во втором поиске
+};
+
+// Результат поиска пути наибольшей пропускной способности
+struct WidestPathResult {
+    double width = 0;   // пропускная способность самой слабой трубы пути
+    vector<int> nodes;  // индексы вершин пути от начала к концу
+    vector<int> arcs;   // индексы ребер пути
+    int settled = 0;    // число окончательно обработанных вершин
+};
+
+// Маршрут фронта Парето по нескольким критериям
+struct ParetoRoute {
+    double length;      // суммарная длина, км
+    double width;       // пропускная способность самой слабой трубы
+    int joints;         // число соединений труба-труба на маршруте
+    vector<int> nodes;  // индексы вершин пути от начала к концу
+    vector<int> arcs;   // индексы ребер пути
+};
+
+struct ParetoFront {
+    vector<ParetoRoute> routes;  // недоминируемые маршруты по возрастанию длины
+    int labels = 0;              // число обработанных меток
+    bool truncated = false;      // часть меток отброшена из-за ограничения набора
+};
+
+// Очереди с приоритетом для поиска кратчайших путей. Общий интерфейс:
+// reset(n) - начало поиска на n вершинах, update(v, key) - вставка вершины или
+// уменьшение ее ключа, pop() - вершина с минимальным ключом, toKey(weight) -
+// вес ребра в единицах ключа. Память очередей переиспользуется между поисками.
+
+// Двоичная куча без уменьшения ключа: update добавляет повторную запись,
+// устаревшие записи пропускаются при извлечении, поэтому размер - до O(E)
+class BinaryHeap {
+private:
+    vector<pair<double, int>> heap;
+
+public:
+    static double toKey(double weight) { return weight; }
+    
+    void reset(int) { heap.clear(); }
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+    double topKey() const { return heap.front().first; }
+    
+    void update(int v, double key) {
+        heap.push_back({key, v});
+        push_heap(heap.begin(), heap.end(), greater<pair<double, int>>());
+    }
+    
+    int pop() {
+        pop_heap(heap.begin(), heap.end(), greater<pair<double, int>>());
+        int v = heap.back().second;
+        heap.pop_back();
+        return v;
+    }
+};
+
+// Адресуемая 4-арная куча с уменьшением ключа: вершина находится в куче не более
+// одного раза (размер до O(V)), дерево в 2 раза ниже двоичного. Позиции вершин
+// сбрасываются лениво: действительны только при метке текущего поиска.
+class QuaternaryHeap {
+private:
+    vector<pair<double, int>> heap;
+    vector<int> position;    // индекс в heap; -1 - вершина уже извлечена
+    vector<unsigned> stamp;  // номер поиска, в котором вершина добавлена
+    unsigned current = 0;
+    
+    void place(int i, const pair<double, int>& item) {
+        heap[i] = item;
+        position[item.second] = i;
+    }
+    
+    void siftUp(int i) {
+        auto item = heap[i];
+        while (i > 0) {
+            int parent = (i - 1) / 4;
+            if (heap[parent].first <= item.first) break;
+            place(i, heap[parent]);
+            i = parent;
+        }
+        place(i, item);
+    }
+    
+    void siftDown(int i) {
+        auto item = heap[i];
+        int size = heap.size();
+        while (true) {
+            int child = 4 * i + 1;
+            if (child >= size) break;
+            int best = child;
+            for (int k = child + 1; k < min(child + 4, size); ++k) {
+                if (heap[k].first < heap[best].first) best = k;
+            }
+            if (heap[best].first >= item.first) break;
+            place(i, heap[best]);
+            i = best;
+        }
+        place(i, item);
+    }
+
+public:
+    static double toKey(double weight) { return weight; }
+    
+    void reset(int n) {
+        if (static_cast<int>(stamp.size()) < n) {
+            position.resize(n);
+            stamp.resize(n, 0);
+        }
+        if (++current == 0) {
+            fill(stamp.begin(), stamp.end(), 0);
+            current = 1;
+        }
+        heap.clear();
+    }
+    
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+    double topKey() const { return heap.front().first; }
+    
+    void update(int v, double key) {
+        if (stamp[v] != current) {
+            stamp[v] = current;
+            heap.push_back({key, v});
+            siftUp(heap.size() - 1);
+        } else if (position[v] >= 0 && key < heap[position[v]].first) {
+            heap[position[v]].first = key;
+            siftUp(position[v]);
+        }
+    }
+    
+    int pop() {
+        int v = heap.front().second;
+        position[v] = -1;
+        auto last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            heap[0] = last;
+            siftDown(0);
+        }
+        return v;
+    }
+};
+
+// Поразрядная (radix) куча для целых неубывающих ключей. Длины труб переводятся
+// в фиксированную точку (1 единица = 1 мм при длине в км), расстояния в поиске
+// становятся целыми. Ключ вставки не меньше последнего извлеченного, поэтому
+// куча не подходит для A* с потенциалом. Извлечение - амортизированно O(log C).
+class RadixHeap {
+private:
+    static constexpr double SCALE = 1e6;
+    
+    array<vector<pair<uint64_t, int>>, 65> buckets;
+    uint64_t last = 0;  // последний извлеченный ключ
+    size_t count = 0;
+    
+    // Номер корзины - старший бит, в котором ключ отличается от last
+    static int bucketOf(uint64_t key, uint64_t last) {
+        uint64_t diff = key ^ last;
+        int bits = 0;
+        for (int shift = 32; shift > 0; shift >>= 1) {
+            if (diff >> shift) {
+                diff >>= shift;
+                bits += shift;
+            }
+        }
+        return bits + static_cast<int>(diff);
+    }
+
+public:
+    static double toKey(double weight) {
+        return weight == numeric_limits<double>::infinity() ? weight : llround(weight * SCALE);
+    }
+    
+    void reset(int) {
+        for (auto& bucket : buckets) bucket.clear();
+        last = 0;
+        count = 0;
+    }
+    
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+    
+    void update(int v, double key) {
+        uint64_t k = static_cast<uint64_t>(key);
+        buckets[bucketOf(k, last)].push_back({k, v});
+        count++;
+    }
+    
+    int pop() {
+        if (buckets[0].empty()) {
+            // Перераспределение первой непустой корзины относительно ее минимума
+            int i = 1;
+            while (buckets[i].empty()) ++i;
+            last = min_element(buckets[i].begin(), buckets[i].end())->first;
+            for (const auto& item : buckets[i]) {
+                buckets[bucketOf(item.first, last)].push_back(item);
+            }
+            buckets[i].clear();
+        }
+        int v = buckets[0].back().second;
+        buckets[0].pop_back();
+        count--;
+        return v;
+    }
+};
+
+// Рабочие массивы поиска одного потока, переиспользуемые между запросами.
+// Значения вершины действительны, только если ее метка равна номеру текущего
+// поиска: новый поиск не очищает массивы, а лишь увеличивает номер, поэтому
+// запрос затрагивает только посещенные вершины и не выделяет память.
+class SearchWorkspace {
+private:
+    vector<double> distance;
+    vector<int> parentArc;
+    vector<unsigned> reachedStamp;
+    vector<unsigned> settledStamp;
+    unsigned current = 0;
+
+public:
+    QuaternaryHeap heap;  // очередь поиска (для dijkstra - параметр шаблона)
+    
+    // Начало нового поиска на графе из n вершин
+    void reset(int n) {
+        if (static_cast<int>(reachedStamp.size()) < n) {
+            distance.resize(n);
+            parentArc.resize(n);
+            reachedStamp.resize(n, 0);
+            settledStamp.resize(n, 0);
+        }
+        if (++current == 0) {
+            // Переполнение номера: метки сбрасываются явно (раз в 2^32 поисков)
+            fill(reachedStamp.begin(), reachedStamp.end(), 0);
+            fill(settledStamp.begin(), settledStamp.end(), 0);
+            current = 1;
+        }
+        heap.reset(n);
+    }
+    
+    double dist(int v) const {
+        return reachedStamp[v] == current ? distance[v] : numeric_limits<double>::infinity();
+    }
+    int parent(int v) const { return reachedStamp[v] == current ? parentArc[v] : -1; }
+    void reach(int v, double d, int arc) {
+        reachedStamp[v] = current;
+        distance[v] = d;
+        parentArc[v] = arc;
+    }
+    
+    bool settled(int v) const { return settledStamp[v] == current; }
+    void settle(int v) { settledStamp[v] = current; }
+    
+    // Рабочие массивы текущего потока (slot - для поисков, идущих одновременно)
+    static SearchWorkspace& local(int slot = 0) {
+        thread_local SearchWorkspace workspaces[2];
+        return workspaces[slot];
+    }
+};
+
+// Поиск кратчайших путей по весам труб. Как и раньше, сеть считается
+// неориентированной: вес есть и у прямого, и у обратного ребра трубы.
+class ShortestPathSolver {
+private:
+    using QueueItem = pair<double, int>;
+    using MinQueue = priority_queue<QueueItem, vector<QueueItem>, greater<QueueItem>>;
+    
+    const NetworkGraph& g;
+
+public:
+    static constexpr double INF = numeric_limits<double>::infinity();
+    
+    explicit ShortestPathSolver(const NetworkGraph& graph) : g(graph) {}
+    
+    // Расстояния от вершины до всех вершин графа
+    vector<double> distancesFrom(int source) const {
+        vector<double> dist(g.nodeCount(), INF);
+        dist[source] = 0;
+        MinQueue pq;
+        pq.push({0, source});
+        while (!pq.empty()) {
+            auto [d, u] = pq.top();
+            pq.pop();
+            if (d > dist[u]) continue;
+            for (int a = g.arcsBegin(u); a < g.arcsEnd(u); ++a) {
+                int v = g.arc(a).to;
+                double nd = d + g.arc(a).weight;
+                if (nd < dist[v]) {
+                    dist[v] = nd;
+                    pq.push({nd, v});
+                }
+            }
+        }
+        return dist;
+    }
+    
+    // Дерево кратчайших путей от вершины (для неориентированной сети - оно же
+    // дерево путей к ней: от v к корню ведут ребра, парные parentArc)
+    ShortestPathTree shortestPathTree(int root) const {
+        ShortestPathTree tree{vector<double>(g.nodeCount(), INF), vector<int>(g.nodeCount(), -1)};
+        tree.dist[root] = 0;
+        MinQueue pq;
+        pq.push({0, root});
+        while (!pq.empty()) {
+            auto [d, u] = pq.top();
+            pq.pop();
+            if (d > tree.dist[u]) continue;
+            for (int a = g.arcsBegin(u); a < g.arcsEnd(u); ++a) {
+                int v = g.arc(a).to;
+                double nd = d + g.arc(a).weight;
+                if (nd < tree.dist[v]) {
+                    tree.dist[v] = nd;
+                    tree.parentArc[v] = a;
+                    pq.push({nd, v});
+                }
+            }
+        }
+        return tree;
+    }
+    
+    // Ответвление для алгоритма Йена: кратчайший путь spur -> target в обход вершин
+    // removedNodes и ребер removedArcs, выходящих из spur. При заданном дереве
+    // кратчайших путей к цели в полном графе путь по дереву берется без поиска,
+    // если удаления его не затрагивают; иначе расстояния дерева - точный потенциал A*.
+    void spurPath(int spur, int target, const vector<int>& removedNodes, const vector<int>& removedArcs,
+                  const ShortestPathTree* tree, SearchWorkspace& ws, ShortestPathResult& result) const {
+        result.distance = INF;
+        result.nodes.clear();
+        result.arcs.clear();
+        result.settled = 0;
+        if (tree && tree->dist[spur] == INF) return;
+        
+        // Удаленные вершины отмечаются как уже обработанные и не раскрываются
+        ws.reset(g.nodeCount());
+        for (int v : removedNodes) ws.settle(v);
+        auto removedArc = [&removedArcs](int a) {
+            return find(removedArcs.begin(), removedArcs.end(), a) != removedArcs.end();
+        };
+        
+        if (tree) {
+            bool intact = true;
+            for (int v = spur; v != target && intact; v = g.tail(tree->parentArc[v])) {
+                int a = g.arc(tree->parentArc[v]).rev;
+                intact = !(v == spur && removedArc(a)) && !ws.settled(g.arc(a).to);
+                result.arcs.push_back(a);
+            }
+            if (intact) {
+                result.distance = 0;
+                result.nodes.push_back(spur);
+                for (int a : result.arcs) {
+                    result.distance += g.arc(a).weight;
+                    result.nodes.push_back(g.arc(a).to);
+                }
+                return;
+            }
+            result.arcs.clear();
+        }
+        
+        ws.reach(spur, 0, -1);
+        ws.heap.update(spur, 0);
+        while (!ws.heap.empty()) {
+            int u = ws.heap.pop();
+            if (ws.settled(u)) continue;
+            ws.settle(u);
+            result.settled++;
+            if (u == target) break;
+            
+            double du = ws.dist(u);
+            for (int a = g.arcsBegin(u); a < g.arcsEnd(u); ++a) {
+                int v = g.arc(a).to;
+                if (ws.settled(v) || (u == spur && removedArc(a))) continue;
+                double h = tree ? tree->dist[v] : 0;
+                double nd = du + g.arc(a).weight;
+                if (h == INF || nd >= ws.dist(v)) continue;
+                ws.reach(v, nd, a);
+                ws.heap.update(v, nd + h);
+            }
+        }
+        
+        if (ws.settled(target) && ws.dist(target) < INF) {
+            result.distance = 0;
+            for (int v = target; v != spur; v = g.tail(ws.parent(v))) {
+                result.arcs.push_back(ws.parent(v));
+            }
+            reverse(result.arcs.begin(), result.arcs.end());
+            result.nodes.push_back(spur);
+            for (int a : result.arcs) {
+                result.distance += g.arc(a).weight;
+                result.nodes.push_back(g.arc(a).to);
+            }
+        }
+    }
+    
+    // Пара путей без общих труб (Суурбалле): поток 2 минимальной стоимости.
+    // Первый путь - по дереву кратчайших путей от источника, расстояния дерева -
+    // потенциалы приведенных стоимостей. Второй путь ищется Дейкстрой в остаточной
+    // сети: трубы первого пути проходятся только в обратную сторону с весом -w
+    // (отмена). Трубы, пройденные обоими путями навстречу, взаимно исключаются.
+    DisjointPathPair disjointPair(int source, int target, const ShortestPathTree& fromSource) const {
+        DisjointPathPair result;
+        if (source == target || fromSource.dist[target] == INF) return result;
+        
+        ShortestPathResult& first = result.paths[0];
+        for (int v = target; v != source; v = g.tail(fromSource.parentArc[v])) {
+            first.arcs.push_back(fromSource.parentArc[v]);
+        }
+        reverse(first.arcs.begin(), first.arcs.end());
+        first.distance = fromSource.dist[target];
+        first.nodes.push_back(source);
+        for (int a : first.arcs) first.nodes.push_back(g.arc(a).to);
+        
+        vector<char> flow(g.arcCount(), 0);
+        for (int a : first.arcs) flow[a] = 1;
+        
+        // Дейкстра по приведенным стоимостям c(u, v) + d(u) - d(v) >= 0
+        const vector<double>& potential = fromSource.dist;
+        SearchWorkspace& ws = SearchWorkspace::local();
+        ws.reset(g.nodeCount());
+        ws.reach(source, 0, -1);
+        ws.heap.update(source, 0);
+        while (!ws.heap.empty()) {
+            int u = ws.heap.pop();
+            if (ws.settled(u)) continue;
+            ws.settle(u);
+            result.settled++;
+            if (u == target) break;
+            
+            double du = ws.dist(u);
+            for (int a = g.arcsBegin(u); a < g.arcsEnd(u); ++a) {
+                int v = g.arc(a).to;
+                double weight = g.arc(a).weight;
+                if (flow[a] || weight == INF || potential[v] == INF) continue;
+                double cost = flow[g.arc(a).rev] ? -weight : weight;
+                double nd = du + max(0.0, cost + potential[u] - potential[v]);
+                if (nd < ws.dist(v)) {
+                    ws.reach(v, nd, a);
+                    ws.heap.update(v, nd);
+                }
+            }
+        }
+        if (!ws.settled(target)) return result;
+        
+        // Сложение путей: отмена встречных проходов по одной трубе
+        for (int v = target; v != source; v = g.tail(ws.parent(v))) {
+            int a = ws.parent(v);
+            if (flow[g.arc(a).rev]) flow[g.arc(a).rev] = 0;
+            else flow[a] = 1;
+        }
+        
+        // Разложение потока 2 на два пути от источника к цели
+        result.totalLength = 0;
+        for (ShortestPathResult& path : result.paths) {
+            path = ShortestPathResult();
+            path.distance = 0;
+            path.nodes.push_back(source);
+            for (int u = source; u != target;) {
+                int a = g.arcsBegin(u);
+                while (!flow[a]) ++a;
+                flow[a] = 0;
+                path.arcs.push_back(a);
+                path.distance += g.arc(a).weight;
+                u = g.arc(a).to;
+                path.nodes.push_back(u);
+            }
+            result.totalLength += path.distance;
+        }
+        if (result.paths[1].distance < result.paths[0].distance) swap(result.paths[0], result.paths[1]);
+        return result;
+    }
+    
+    // Пропускная способность путей наибольшей ширины от вершины до всех вершин
+    // (0 - вершина недостижима по трубам с ненулевой пропускной способностью)
+    vector<double> widthsFrom(int source) const {
+        vector<double> width(g.nodeCount(), 0);
+        width[source] = INF;
+        priority_queue<QueueItem> pq;
+        pq.push({INF, source});
+        while (!pq.empty()) {
+            auto [w, u] = pq.top();
+            pq.pop();
+            if (w < width[u]) continue;
+            for (int a = g.arcsBegin(u); a < g.arcsEnd(u); ++a) {
+                int v = g.arc(a).to;
+                double nw = min(w, g.pipeCapacity(a));
+                if (nw > width[v]) {
+                    width[v] = nw;
+                    pq.push({nw, v});
+                }
+            }
+        }
+        return width;
+    }
+    
+    // Расстояния от вершины до отмеченных целей (isTarget), поиск останавливается,
+    // когда обработаны все targetCount целей. Результат - workspace.dist(v).
+    void distancesTo(int source, const vector<char>& isTarget, int targetCount, SearchWorkspace& workspace) const {
+        workspace.reset(g.nodeCount());
+        workspace.reach(source, 0, -1);
+        workspace.heap.update(source, 0);
+        while (!workspace.heap.empty() && targetCount > 0) {
+            int u = workspace.heap.pop();
+            if (workspace.settled(u)) continue;
+            workspace.settle(u);
+            if (isTarget[u]) targetCount--;
+            double d = workspace.dist(u);
+            for (int a = g.arcsBegin(u); a < g.arcsEnd(u); ++a) {
+                int v = g.arc(a).to;
+                double nd = d + g.arc(a).weight;
+                if (nd < workspace.dist(v)) {
+                    workspace.reach(v, nd, a);
+                    workspace.heap.update(v, nd);
+                }
+            }
+        }
+    }
+    
+    // Дейкстра (с остановкой при извлечении цели) или A* при заданной оценке
+    // potential(v) - нижней границе расстояния от v до цели. Queue - очередь
+    // с приоритетом (BinaryHeap, QuaternaryHeap, RadixHeap без потенциала);
+    // расстояния в поиске - в единицах ее ключа. Массивы поиска и очередь -
+    // из рабочей области потока, result переиспользует память своих векторов.
+    // По умолчанию - 4-арная куча, самая быстрая в бенчмарке очередей.
+    template <class Queue = QuaternaryHeap>
+    void dijkstra(int source, int target, ShortestPathResult& result,
+                  const function<double(int)>& potential = nullptr) const {
+        result.distance = INF;
+        result.nodes.clear();
+        result.arcs.clear();
+        result.settled = 0;
+        
+        thread_local Queue queue;
+        SearchWorkspace& ws = SearchWorkspace::local();
+        ws.reset(g.nodeCount());
+        queue.reset(g.nodeCount());
+        ws.reach(source, 0, -1);
+        queue.update(source, potential ? potential(source) : 0);
+        
+        while (!queue.empty()) {
+            int u = queue.pop();
+            if (ws.settled(u)) continue;
+            ws.settle(u);
+            result.settled++;
+            if (u == target) break;
+            
+            double du = ws.dist(u);
+            for (int a = g.arcsBegin(u); a < g.arcsEnd(u); ++a) {
+                int v = g.arc(a).to;
+                double nd = du + Queue::toKey(g.arc(a).weight);
+                if (nd < ws.dist(v)) {
+                    double key = nd;
+                    if (potential) {
+                        double h = potential(v);
+                        if (h == INF) continue;
+                        key += h;
+                    }
+                    ws.reach(v, nd, a);
+                    queue.update(v, key);
+                }
+            }
+        }
+        
+        if (ws.dist(target) < INF) {
+            // Длина - сумма весов ребер пути (для RadixHeap - без округления)
+            result.distance = 0;
+            for (int v = target; v != source; v = g.tail(ws.parent(v))) {
+                result.arcs.push_back(ws.parent(v));
+            }
+            reverse(result.arcs.begin(), result.arcs.end());
+            result.nodes.push_back(source);
+            for (int a : result.arcs) {
+                result.distance += g.arc(a).weight;
+                result.nodes.push_back(g.arc(a).to);
+            }
+        }
+    }
+    
+    ShortestPathResult dijkstra(int source, int target,
+                                const function<double(int)>& potential = nullptr) const {
+        ShortestPathResult result;
+        dijkstra(source, target, result, potential);
+        return result;
+    }
+    
+    // Путь наибольшей пропускной способности (максимум по самой слабой трубе):
+    // Дейкстра, в котором расстояние - минус ширина пути, а вместо суммы весов
+    // берется максимум. Трубы без пропускной способности (в ремонте) не используются.
+    void widest(int source, int target, WidestPathResult& result) const {
+        result.width = 0;
+        result.nodes.clear();
+        result.arcs.clear();
+        result.settled = 0;
+        
+        thread_local QuaternaryHeap queue;
+        SearchWorkspace& ws = SearchWorkspace::local();
+        ws.reset(g.nodeCount());
+        queue.reset(g.nodeCount());
+        ws.reach(source, -INF, -1);
+        queue.update(source, -INF);
+        
+        while (!queue.empty()) {
+            int u = queue.pop();
+            if (ws.settled(u)) continue;
+            ws.settle(u);
+            result.settled++;
+            if (u == target) break;
+            
+            double du = ws.dist(u);
+            for (int a = g.arcsBegin(u); a < g.arcsEnd(u); ++a) {
+                double capacity = g.pipeCapacity(a);
+                if (capacity <= 0) continue;
+                int v = g.arc(a).to;
+                double nd = max(du, -capacity);
+                if (nd < ws.dist(v)) {
+                    ws.reach(v, nd, a);
+                    queue.update(v, nd);
+                }
+            }
+        }
+        
+        if (ws.dist(target) < INF) {
+            result.width = -ws.dist(target);
+            for (int v = target; v != source; v = g.tail(ws.parent(v))) {
+                result.arcs.push_back(ws.parent(v));
+            }
+            reverse(result.arcs.begin(), result.arcs.end());
+            result.nodes.push_back(source);
+            for (int a : result.arcs) result.nodes.push_back(g.arc(a).to);
+        }
+    }
+    
+    // Фронт Парето маршрутов по (длине, пропускной способности, числу соединений
+    // труба-труба; jointPipe[ID трубы] = 1 для таких соединений). Многокритериальный
+    // поиск с установкой меток: метки извлекаются в порядке (длина, соединения,
+    // -ширина), поэтому доминирующая метка обрабатывается раньше доминируемой.
+    // Метка отбрасывается, если ее доминирует метка вершины или если найденный
+    // маршрут доминирует лучшее возможное продолжение метки (оценка по кратчайшему
+    // расстоянию и наибольшей ширине до цели); набор меток вершины ограничен labelLimit.
+    ParetoFront paretoRoutes(int source, int target, const vector<char>& jointPipe, int labelLimit) const {
+        struct Label {
+            double length;
+            double width;
+            int joints;
+            int node;
+            int parent;  // индекс предыдущей метки (-1 у начальной)
+            int arc;
+        };
+        auto dominates = [](const Label& a, const Label& b) {
+            return a.length <= b.length && a.width >= b.width && a.joints <= b.joints;
+        };
+        
+        vector<Label> labels;
+        vector<vector<int>> bags(g.nodeCount());  // обработанные метки вершины
+        auto dominatedAt = [&](int v, const Label& label) {
+            for (int i : bags[v]) {
+                if (dominates(labels[i], label)) return true;
+            }
+            return false;
+        };
+        
+        // Оценки продолжения до цели (сеть неориентированная - поиск от цели)
+        vector<double> lengthBound = distancesFrom(target);
+        vector<double> widthBound = widthsFrom(target);
+        auto hopeless = [&](const Label& label) {
+            if (lengthBound[label.node] == INF) return true;
+            Label best = label;
+            best.length += lengthBound[label.node];
+            best.width = min(best.width, widthBound[label.node]);
+            return dominatedAt(target, best);
+        };
+        
+        using QueueKey = tuple<double, int, double, int>;
+        priority_queue<QueueKey, vector<QueueKey>, greater<QueueKey>> pq;
+        ParetoFront front;
+        
+        labels.push_back({0, INF, 0, source, -1, -1});
+        pq.push({0, 0, -INF, 0});
+        while (!pq.empty()) {
+            int id = get<3>(pq.top());
+            pq.pop();
+            Label label = labels[id];
+            if (dominatedAt(label.node, label) || hopeless(label)) continue;
+            if (static_cast<int>(bags[label.node].size()) >= labelLimit) {
+                front.truncated = true;
+                continue;
+            }
+            bags[label.node].push_back(id);
+            front.labels++;
+            if (label.node == target) continue;
+            
+            for (int a = g.arcsBegin(label.node); a < g.arcsEnd(label.node); ++a) {
+                double capacity = g.pipeCapacity(a);
+                double weight = g.arc(a).weight;
+                if (capacity <= 0 || weight == INF) continue;
+                int pipeId = g.arc(a).pipeId;
+                bool joint = pipeId >= 0 && pipeId < static_cast<int>(jointPipe.size()) && jointPipe[pipeId];
+                Label next{label.length + weight, min(label.width, capacity), label.joints + joint,
+                           g.arc(a).to, id, a};
+                if (dominatedAt(next.node, next) || hopeless(next)) continue;
+                labels.push_back(next);
+                pq.push({next.length, next.joints, -next.width, static_cast<int>(labels.size()) - 1});
+            }
+        }
+        
+        for (int id : bags[target]) {
+            const Label& last = labels[id];
+            ParetoRoute route{last.length, last.width, last.joints, {}, {}};
+            for (int i = id; labels[i].parent != -1; i = labels[i].parent) {
+                route.arcs.push_back(labels[i].arc);
+            }
+            reverse(route.arcs.begin(), route.arcs.end());
+            route.nodes.push_back(source);
+            for (int a : route.arcs) route.nodes.push_back(g.arc(a).to);
+            front.routes.push_back(move(route));
+        }
+        return front;
+    }
+    
+    // Двунаправленный Дейкстра: поиски от начала и от конца до встречи
+    void bidirectional(int source, int target, ShortestPathResult& result) const {
+        result.distance = INF;
+        result.nodes.clear();
+        result.arcs.clear();
+        result.settled = 0;
+        
+        SearchWorkspace* ws[2] = {&SearchWorkspace::local(0), &SearchWorkspace::local(1)};
+        for (SearchWorkspace* side : ws) side->reset(g.nodeCount());
+        ws[0]->reach(source, 0, -1);
+        ws[1]->reach(target, 0, -1);
+        ws[0]->heap.update(source, 0);
+        ws[1]->heap.update(target, 0);
+        
+        double best = source == target ? 0 : INF;
+        int meeting = source == target ? source : -1;
+        
+        while (!ws[0]->heap.empty() && !ws[1]->heap.empty()) {
+            if (ws[0]->heap.topKey() + ws[1]->heap.topKey() >= best) break;
+            
+            // Расширяем направление с меньшей очередью
+            int side = ws[0]->heap.size() <= ws[1]->heap.size() ? 0 : 1;
+            SearchWorkspace& own = *ws[side];
+            const SearchWorkspace& other = *ws[1 - side];
+            int u = own.heap.pop();
+            if (own.settled(u)) continue;
+            own.settle(u);
+            result.settled++;
+            
+            double du = own.dist(u);
+            for (int a = g.arcsBegin(u); a < g.arcsEnd(u); ++a) {
+                int v = g.arc(a).to;
+                double nd = du + g.arc(a).weight;
+                if (nd < own.dist(v)) {
+                    // Для обратного поиска храним ребро v -> u (парное)
+                    own.reach(v, nd, side == 0 ? a : g.arc(a).rev);
+                    own.heap.update(v, nd);
+                }
+                if (other.dist(v) < INF && nd + other.dist(v) < best) {
+                    best = nd + other.dist(v);
+                    meeting = v;
+                }
+            }
+        }
+        
+        if (meeting != -1) {
+            result.distance = best;
+            for (int v = meeting; v != source; v = g.tail(ws[0]->parent(v))) {
+                result.arcs.push_back(ws[0]->parent(v));
+            }
+            reverse(result.arcs.begin(), result.arcs.end());
+            for (int v = meeting; v != target; v = g.arc(ws[1]->parent(v)).to) {
+                result.arcs.push_back(ws[1]->parent(v));
+            }
+            result.nodes.push_back(source);
+            for (int a : result.arcs) result.nodes.push_back(g.arc(a).to);
+        }
+    }
+    
+    ShortestPathResult bidirectional(int source, int target) const {
+        ShortestPathResult result;
+        bidirectional(source, target, result);
+        return result;
+    }
+};
+
+// Таблица расстояний от ориентиров для A* (ALT). Ориентиры делятся между
+// крупными компонентами связности пропорционально их размеру и внутри
+// компоненты выбираются по принципу наиболее удаленной точки; обрывки сети
+// (в том числе отключенные вершины) ориентиров не получают.
+// Таблица строится для версии графа.
+class LandmarkTable {
+private:
+    vector<int> landmarks;
+    vector<vector<double>> distances;  // distances[i][v] - от ориентира i до v
+    vector<int> component;             // компонента связности вершины (трубы в ремонте не учитываются)
+    long long version = -1;
+
+    // Компоненты связности по трубам не в ремонте; возвращает вершины каждой компоненты
+    vector<vector<int>> findComponents(const NetworkGraph& graph) {
+        int n = graph.nodeCount();
+        component.assign(n, -1);
+        vector<vector<int>> members;
+        for (int root = 0; root < n; ++root) {
+            if (component[root] != -1) continue;
+            int c = members.size();
+            members.push_back({root});
+            component[root] = c;
+            vector<int>& part = members.back();
+            for (size_t head = 0; head < part.size(); ++head) {
+                int u = part[head];
+                for (int a = graph.arcsBegin(u); a < graph.arcsEnd(u); ++a) {
+                    int v = graph.arc(a).to;
+                    if (graph.arc(a).weight == ShortestPathSolver::INF || component[v] != -1) continue;
+                    component[v] = c;
+                    part.push_back(v);
+                }
+            }
+        }
+        return members;
+    }
+
+    // count ориентиров в компоненте: первый - самая удаленная вершина от
+    // произвольной, следующий - самая удаленная от уже выбранных
+    void selectFarthest(const ShortestPathSolver& solver, const vector<int>& part, int count,
+                        vector<double>& nearest) {
+        vector<double> fromStart = solver.distancesFrom(part[0]);
+        int next = part[0];
+        for (int v : part) {
+            if (fromStart[v] > fromStart[next]) next = v;
+        }
+        for (int i = 0; i < count; ++i) {
+            landmarks.push_back(next);
+            distances.push_back(solver.distancesFrom(next));
+            const vector<double>& dist = distances.back();
+            
+            int farthest = next;
+            for (int v : part) {
+                nearest[v] = min(nearest[v], dist[v]);
+                if (nearest[v] > nearest[farthest]) farthest = v;
+            }
+            if (nearest[farthest] <= 0) break;
+            next = farthest;
+        }
+    }
+
+public:
+    void build(const NetworkGraph& graph, int count) {
+        ShortestPathSolver solver(graph);
+        landmarks.clear();
+        distances.clear();
+        vector<vector<int>> members = findComponents(graph);
+        
+        // Крупная компонента - не меньше доли сети, приходящейся на один ориентир;
+        // таких компонент не больше count
+        vector<int> order;
+        int covered = 0;
+        for (size_t c = 0; c < members.size(); ++c) {
+            if (members[c].size() < 2) continue;
+            order.push_back(c);
+            covered += members[c].size();
+        }
+        int minSize = count > 0 ? max(2, (covered + count - 1) / count) : covered + 1;
+        sort(order.begin(), order.end(), [&members](int x, int y) {
+            return members[x].size() > members[y].size();
+        });
+        while (!order.empty() && static_cast<int>(members[order.back()].size()) < minSize) {
+            order.pop_back();
+        }
+        
+        // Доли пропорциональны размеру (не меньше одного ориентира),
+        // остаток от округления получает наибольшая компонента
+        int sizeable = 0;
+        for (int c : order) sizeable += members[c].size();
+        vector<int> share(order.size());
+        int assigned = 0;
+        for (size_t i = 1; i < order.size(); ++i) {
+            share[i] = max<long long>(1, static_cast<long long>(count) * members[order[i]].size() / sizeable);
+            assigned += share[i];
+        }
+        if (!order.empty()) share[0] = count - assigned;
+        
+        vector<double> nearest(graph.nodeCount(), ShortestPathSolver::INF);
+        for (size_t i = 0; i < order.size(); ++i) {
+            selectFarthest(solver, members[order[i]], share[i], nearest);
+        }
+        version = graph.getVersion();
+    }
+    
+    long long getVersion() const { return version; }
+    int size() const { return landmarks.size(); }
+    
+    // Нижняя граница расстояния от v до target по неравенству треугольника
+    double lowerBound(int v, int target) const {
+        if (component[v] != component[target]) return ShortestPathSolver::INF;
+        double bound = 0;
+        for (const auto& dist : distances) {
+            double dv = dist[v];
+            double dt = dist[target];
+            if (dv == ShortestPathSolver::INF) continue;  // ориентир другой компоненты
+            bound = max(bound, fabs(dt - dv));
+        }
+        return bound;
+    }
+};
+
+// Максимальный остовный лес по пропускной способности труб (алгоритм Крускала).
+// Путь между вершинами в этом лесу - путь наибольшей пропускной способности,
+// поэтому запрос поднимается по дереву от обеих вершин за O(длины пути).
+// Лес строится для версии графа, трубы в ремонте в него не входят.
+class WidestPathTree {
+private:
+    vector<int> upArc;      // ребро от вершины к родителю (-1 у корня)
+    vector<int> depth;
+    vector<int> root;       // корень дерева вершины (компонента связности)
+    long long version = -1;
+
+public:
+    void build(const NetworkGraph& g) {
+        int n = g.nodeCount();
+        vector<int> candidates;
+        for (int u = 0; u < n; ++u) {
+            for (int a = g.arcsBegin(u); a < g.arcsEnd(u); ++a) {
+                if (g.arc(a).forward && g.arc(a).capacity > 0) candidates.push_back(a);
+            }
+        }
+        sort(candidates.begin(), candidates.end(), [&g](int a, int b) {
+            return g.arc(a).capacity > g.arc(b).capacity;
+        });
+        
+        // Система непересекающихся множеств с сокращением путей
+        vector<int> leader(n);
+        for (int v = 0; v < n; ++v) leader[v] = v;
+        auto find = [&leader](int v) {
+            while (leader[v] != v) {
+                leader[v] = leader[leader[v]];
+                v = leader[v];
+            }
+            return v;
+        };
+        
+        vector<char> inTree(g.arcCount(), 0);
+        for (int a : candidates) {
+            int x = find(g.tail(a));
+            int y = find(g.arc(a).to);
+            if (x == y) continue;
+            leader[x] = y;
+            inTree[a] = inTree[g.arc(a).rev] = 1;
+        }
+        
+        // Подвешивание деревьев обходом в ширину
+        upArc.assign(n, -1);
+        depth.assign(n, -1);
+        root.assign(n, -1);
+        vector<int> q;
+        q.reserve(n);
+        for (int r = 0; r < n; ++r) {
+            if (depth[r] != -1) continue;
+            depth[r] = 0;
+            root[r] = r;
+            q.assign(1, r);
+            for (size_t head = 0; head < q.size(); ++head) {
+                int u = q[head];
+                for (int a = g.arcsBegin(u); a < g.arcsEnd(u); ++a) {
+                    int v = g.arc(a).to;
+                    if (!inTree[a] || depth[v] != -1) continue;
+                    depth[v] = depth[u] + 1;
+                    root[v] = r;
+                    upArc[v] = g.arc(a).rev;
+                    q.push_back(v);
+                }
+            }
+        }
+        version = g.getVersion();
+    }
+    
+    long long getVersion() const { return version; }
+    
+    void query(const NetworkGraph& g, int source, int target, WidestPathResult& result) const {
+        result.width = 0;
+        result.nodes.clear();
+        result.arcs.clear();
+        result.settled = 0;
+        if (root[source] != root[target]) return;
+        
+        // Подъем к общему предку: ребра от source - сразу в путь,
+        // ребра от target - в обратном порядке в конец пути
+        thread_local vector<int> fromTarget;
+        fromTarget.clear();
+        int x = source, y = target;
+        while (x != y) {
+            if (depth[x] >= depth[y]) {
+                result.arcs.push_back(upArc[x]);
+                x = g.arc(upArc[x]).to;
+            } else {
+                fromTarget.push_back(g.arc(upArc[y]).rev);
+                y = g.arc(upArc[y]).to;
+            }
+        }
+        result.arcs.insert(result.arcs.end(), fromTarget.rbegin(), fromTarget.rend());
+        
+        result.width = numeric_limits<double>::infinity();
+        result.nodes.push_back(source);
+        for (int a : result.arcs) {
+            result.width = min(result.width, g.pipeCapacity(a));
+            result.nodes.push_back(g.arc(a).to);
+        }
+    }
+};
+
+// Критический элемент сети: при выводе из работы отделяет cutOff вершин
+// от наибольшей оставшейся части своей компоненты связности
+struct CriticalElement {
+    int element;  // индекс ребра (труба) или индекс вершины (объект)
+    int cutOff;   // число отделяемых вершин
+};
+
+struct CriticalElementsResult {
+    vector<CriticalElement> bridges;            // трубы-мосты (индексы прямых ребер)
+    vector<CriticalElement> articulationPoints; // точки сочленения (индексы вершин)
+    int components = 0;                         // компоненты связности без труб в ремонте
+    int maxDepth = 0;                           // наибольшая глубина обхода
+};
+
+// Мосты и точки сочленения по Тарьяну за O(V + E) без рекурсии: обход в глубину
+// на явном стеке, поэтому глубина сети ограничена только памятью.
+// Трубы в ремонте не учитываются, параллельные трубы не являются мостами.
+class CriticalElementsAnalyzer {
+public:
+    static CriticalElementsResult analyze(const NetworkGraph& g) {
+        CriticalElementsResult result;
+        int n = g.nodeCount();
+        vector<int> order(n, -1);      // время входа
+        vector<int> low(n, 0);         // наименьшее время входа, достижимое из поддерева
+        vector<int> subtree(n, 0);     // размер поддерева обхода
+        vector<int> parentArc(n, -1);  // ребро, по которому вошли в вершину
+        vector<int> nextArc(n, 0);     // следующее непросмотренное ребро вершины
+        vector<int> separated(n, 0);   // вершины поддеревьев, отрезаемых вершиной
+        vector<int> largestPart(n, 0); // наибольшее из таких поддеревьев
+        vector<int> stack, visited, bridgeChildren;
+        int timer = 0;
+        
+        for (int root = 0; root < n; ++root) {
+            if (order[root] != -1 || g.isDetached(root)) continue;
+            ++result.components;
+            visited.clear();
+            bridgeChildren.clear();
+            
+            auto enter = [&](int v, int arc) {
+                order[v] = low[v] = timer++;
+                subtree[v] = 1;
+                parentArc[v] = arc;
+                nextArc[v] = g.arcsBegin(v);
+                stack.push_back(v);
+                visited.push_back(v);
+            };
+            enter(root, -1);
+            
+            while (!stack.empty()) {
+                int u = stack.back();
+                result.maxDepth = max(result.maxDepth, static_cast<int>(stack.size()));
+                if (nextArc[u] < g.arcsEnd(u)) {
+                    int a = nextArc[u]++;
+                    const GraphEdge& e = g.arc(a);
+                    if (e.to < 0 || e.weight == numeric_limits<double>::infinity()) continue;
+                    if (parentArc[u] != -1 && g.arc(parentArc[u]).rev == a) continue;
+                    if (order[e.to] == -1) {
+                        enter(e.to, a);
+                    } else {
+                        low[u] = min(low[u], order[e.to]);
+                    }
+                    continue;
+                }
+                
+                stack.pop_back();
+                if (parentArc[u] == -1) continue;
+                int p = g.tail(parentArc[u]);
+                low[p] = min(low[p], low[u]);
+                subtree[p] += subtree[u];
+                if (low[u] >= order[p]) {
+                    separated[p] += subtree[u];
+                    largestPart[p] = max(largestPart[p], subtree[u]);
+                }
+                if (low[u] > order[p]) bridgeChildren.push_back(u);
+            }
+            
+            // Размеры отрезаемых частей известны только после обхода всей компоненты
+            int size = visited.size();
+            for (int v : bridgeChildren) {
+                int a = parentArc[v];
+                if (!g.arc(a).forward) a = g.arc(a).rev;
+                result.bridges.push_back({a, min(subtree[v], size - subtree[v])});
+            }
+            for (int v : visited) {
+                // Части после удаления v: отрезанные поддеревья и остаток компоненты
+                int rest = size - 1 - separated[v];
+                int cutOff = size - 1 - max(largestPart[v], rest);
+                if (cutOff > 0) result.articulationPoints.push_back({v, cutOff});
+            }
+        }
+        
+        auto byCutOff = [](const CriticalElement& x, const CriticalElement& y) {
+            return x.cutOff != y.cutOff ? x.cutOff > y.cutOff : x.element < y.element;
+        };
+        sort(result.bridges.begin(), result.bridges.end(), byCutOff);
+        sort(result.articulationPoints.begin(), result.articulationPoints.end(), byCutOff);
+        return result;
+    }
+};
+
+// Число рабочих потоков для параллельных расчетов
+static int parallelWorkers() {
+    return max(1u, thread::hardware_concurrency());
+}
+
+// Параллельная обработка элементов 0..count-1: потоки забирают элементы
+// порциями из общего счетчика, body(worker, i) получает номер потока.
+// grain - число элементов на поток, при котором параллельность окупается
+// (1 для тяжелых элементов, например отдельных расчетов потока)
+static void parallelFor(int count, const function<void(int, int)>& body, int grain = 64) {
+    int workers = min(parallelWorkers(), max(1, count / grain));
+    if (workers == 1) {
+        for (int i = 0; i < count; ++i) body(0, i);
+        return;
+    }
+    
+    const int chunk = max(1, grain / 2);
+    atomic<int> next(0);
+    auto worker = [&](int w) {
+        for (int begin = next.fetch_add(chunk); begin < count; begin = next.fetch_add(chunk)) {
+            int end = min(count, begin + chunk);
+            for (int i = begin; i < end; ++i) body(w, i);
+        }
+    };
+    vector<thread> pool;
+    for (int w = 1; w < workers; ++w) pool.emplace_back(worker, w);
+    worker(0);
+    for (auto& t : pool) t.join();
+}
+
+// k кратчайших путей без циклов (алгоритм Йена). Очередной путь - лучший из
+// кандидатов, полученных ответвлением от каждой вершины предыдущего пути:
+// общий с найденными путями префикс сохраняется, следующие за ним ребра этих
+// путей и вершины префикса удаляются. Ответвления одной итерации ищутся
+// параллельно; дерево кратчайших путей к цели строится один раз на запрос.
+class KShortestPathsSolver {
+private:
+    const NetworkGraph& g;
+
+public:
+    explicit KShortestPathsSolver(const NetworkGraph& graph) : g(graph) {}
+    
+    // Пути по возрастанию длины; reuseTree = false - ответвления без дерева (для сравнения)
+    vector<ShortestPathResult> run(int source, int target, int k, bool reuseTree = true) const {
+        vector<ShortestPathResult> found;
+        if (k <= 0) return found;
+        
+        ShortestPathSolver solver(g);
+        ShortestPathTree tree;
+        if (reuseTree) tree = solver.shortestPathTree(target);
+        const ShortestPathTree* treePtr = reuseTree ? &tree : nullptr;
+        vector<SearchWorkspace> workspaces(parallelWorkers());
+        
+        ShortestPathResult first;
+        solver.spurPath(source, target, {}, {}, treePtr, workspaces[0], first);
+        if (first.distance == ShortestPathSolver::INF) return found;
+        found.push_back(move(first));
+        
+        vector<ShortestPathResult> candidates;
+        set<vector<int>> known;  // ребра уже найденных путей и кандидатов
+        known.insert(found[0].arcs);
+        
+        while (static_cast<int>(found.size()) < k) {
+            const ShortestPathResult& previous = found.back();
+            int spurCount = previous.arcs.size();
+            vector<ShortestPathResult> spurs(spurCount);
+            
+            // Путей-ответвлений столько, сколько ребер в пути (обычно десятки),
+            // и каждое - отдельный поиск, поэтому раздаются по одному
+            parallelFor(spurCount, [&](int worker, int i) {
+                vector<int> removedNodes(previous.nodes.begin(), previous.nodes.begin() + i);
+                vector<int> removedArcs;
+                for (const auto& path : found) {
+                    if (static_cast<int>(path.arcs.size()) > i &&
+                        equal(previous.arcs.begin(), previous.arcs.begin() + i, path.arcs.begin())) {
+                        removedArcs.push_back(path.arcs[i]);
+                    }
+                }
+                solver.spurPath(previous.nodes[i], target, removedNodes, removedArcs, treePtr,
+                                workspaces[worker], spurs[i]);
+            }, 1);
+            
+            for (int i = 0; i < spurCount; ++i) {
+                if (spurs[i].distance == ShortestPathSolver::INF) continue;
+                ShortestPathResult candidate;
+                candidate.arcs.assign(previous.arcs.begin(), previous.arcs.begin() + i);
+                candidate.arcs.insert(candidate.arcs.end(), spurs[i].arcs.begin(), spurs[i].arcs.end());
+                if (!known.insert(candidate.arcs).second) continue;
+                
+                candidate.distance = 0;
+                candidate.nodes.push_back(source);
+                for (int a : candidate.arcs) {
+                    candidate.distance += g.arc(a).weight;
+                    candidate.nodes.push_back(g.arc(a).to);
+                }
+                candidate.settled = spurs[i].settled;
+                candidates.push_back(move(candidate));
+            }
+            if (candidates.empty()) break;
+            
+            // Лучший кандидат: наименьшая длина, при равенстве - меньше труб
+            auto best = min_element(candidates.begin(), candidates.end(),
+                                    [](const ShortestPathResult& a, const ShortestPathResult& b) {
+                                        return make_pair(a.distance, a.arcs.size()) < make_pair(b.distance, b.arcs.size());
+                                    });
+            found.push_back(move(*best));
+            if (best != candidates.end() - 1) *best = move(candidates.back());
+            candidates.pop_back();
+        }
+        return found;
+    }
+};
+
+// Отказ трубы в анализе N-1: поток источник -> сток при трубе в ремонте
+struct PipeOutage {
+    int pipeId;
+    double baseFlow;  // поток по трубе в исходном решении
+    double value;     // максимальный поток без трубы
+    double loss;      // потеря пропускной способности сети
+};
+
+struct ContingencyResult {
+    double baseValue = 0;        // максимальный поток без отказов
+    vector<PipeOutage> outages;  // рассчитанные отказы по убыванию потери
+    int skipped = 0;             // трубы без потока в исходном решении (потеря 0)
+};
+
+// Анализ отказов N-1: для каждой работающей трубы - максимальный поток с этой
+// трубой в ремонте. Трубы без потока в исходном решении пропускаются: исходный
+// поток остается допустимым и максимальным. Остальные отказы считаются
+// параллельно, у каждого потока своя копия графа, в которой труба временно
+// отключается; расчет ведется от исходного потока (warmStart).
+class ContingencyAnalyzer {
+public:
+    static ContingencyResult run(const NetworkGraph& g, int source, int sink, bool warm = true) {
+        const double eps = 1e-9;
+        ContingencyResult result;
+        MaxFlowResult base = MaxFlowSolver(g, source, sink).run(DINIC);
+        result.baseValue = base.value;
+        
+        vector<int> affected;
+        for (int pipeId = 0; pipeId < g.pipeIdLimit(); ++pipeId) {
+            int a = g.forwardArc(pipeId);
+            if (a == -1 || g.arc(a).capacity <= 0) continue;
+            if (fabs(base.pipeFlow[pipeId]) > eps) {
+                affected.push_back(pipeId);
+            } else {
+                ++result.skipped;
+            }
+        }
+        
+        result.outages.resize(affected.size());
+        vector<unique_ptr<NetworkGraph>> copies(parallelWorkers());
+        parallelFor(affected.size(), [&](int worker, int i) {
+            if (!copies[worker]) copies[worker].reset(new NetworkGraph(g));
+            NetworkGraph& local = *copies[worker];
+            int pipeId = affected[i];
+            const GraphEdge& e = g.arc(g.forwardArc(pipeId));
+            
+            local.applyDelta({ARC_UPDATED, pipeId, 0, 0, 0.0, numeric_limits<double>::infinity()}, g.getVersion());
+            MaxFlowSolver solver(local, source, sink);
+            double value = warm ? solver.warmStart(base.pipeFlow).value : solver.run(DINIC).value;
+            local.applyDelta({ARC_UPDATED, pipeId, 0, 0, e.capacity, e.weight}, g.getVersion());
+            
+            result.outages[i] = {pipeId, base.pipeFlow[pipeId], value, max(0.0, base.value - value)};
+        }, 1);
+        
+        sort(result.outages.begin(), result.outages.end(), [](const PipeOutage& x, const PipeOutage& y) {
+            return x.loss != y.loss ? x.loss > y.loss : x.pipeId < y.pipeId;
+        });
+        return result;
+    }
+};
+
+// Дерево Гомори-Ху (эквивалентное дерево потоков, алгоритм Гасфилда) для
+// неориентированного представления сети: максимальный поток между любыми
+// вершинами равен наименьшему весу ребра на пути между ними в дереве.
+// Строится n - 1 расчетом потока. Расчеты идут пакетами параллельно по текущим
+// родителям; результат принимается по порядку, пока родитель вершины не изменился
+// более ранним разрезом пакета, остальные вершины пересчитываются в следующем пакете.
+class GomoryHuTree {
+private:
+    struct Cut {
+        int sink = -1;        // родитель, для которого считался разрез
+        double value = 0;
+        vector<int> sourceSide;
+    };
+    
+    vector<int> parent;     // родитель в дереве (-1 у корня)
+    vector<double> weight;  // максимальный поток между вершиной и родителем
+    vector<int> depth;
+    long long version = -1;
+    int cutsComputed = 0;
+    
+    // Минимальный разрез s-t: доля источника по достижимости в остаточной сети
+    static void minCut(const NetworkGraph& g, int s, int t, Cut& cut) {
+        const double eps = 1e-9;
+        MaxFlowResult flow = MaxFlowSolver(g, s, t).run(DINIC);
+        cut.sink = t;
+        cut.value = flow.value;
+        cut.sourceSide.assign(1, s);
+        vector<char> seen(g.nodeCount(), 0);
+        seen[s] = 1;
+        for (size_t head = 0; head < cut.sourceSide.size(); ++head) {
+            int u = cut.sourceSide[head];
+            for (int a = g.arcsBegin(u); a < g.arcsEnd(u); ++a) {
+                int v = g.arc(a).to;
+                if (seen[v] || g.arc(a).capacity - flow.arcFlow[a] <= eps) continue;
+                seen[v] = 1;
+                cut.sourceSide.push_back(v);
+            }
+        }
+    }
+
+public:
+    // g - граф сети; пропускные способности берутся в неориентированном виде.
+    // batchSize - число разрезов, считаемых параллельно за один пакет
+    void build(const NetworkGraph& g, int batchSize = parallelWorkers()) {
+        NetworkGraph undirected = g;
+        undirected.makeUndirected();
+        int n = g.nodeCount();
+        parent.assign(n, 0);
+        weight.assign(n, 0.0);
+        cutsComputed = 0;
+        if (n > 0) parent[0] = -1;
+        
+        vector<Cut> cuts(n);
+        vector<int> todo;
+        for (int next = 1; next < n;) {
+            int end = min(n, next + max(1, batchSize));
+            todo.clear();
+            for (int s = next; s < end; ++s) {
+                if (cuts[s].sink != parent[s]) todo.push_back(s);
+            }
+            parallelFor(todo.size(), [&](int, int i) {
+                minCut(undirected, todo[i], parent[todo[i]], cuts[todo[i]]);
+            }, 1);
+            cutsComputed += todo.size();
+            
+            // Принятие разрезов по порядку (как в последовательном алгоритме)
+            for (; next < end && cuts[next].sink == parent[next]; ++next) {
+                int s = next, t = parent[s];
+                weight[s] = cuts[s].value;
+                for (int v : cuts[s].sourceSide) {
+                    if (v > s && parent[v] == t) parent[v] = s;
+                }
+                vector<int>().swap(cuts[s].sourceSide);
+            }
+        }
+        
+        // Родитель всегда имеет меньший индекс, глубины считаются одним проходом
+        depth.assign(n, 0);
+        for (int v = 1; v < n; ++v) depth[v] = depth[parent[v]] + 1;
+        version = g.getVersion();
+    }
+    
+    long long getVersion() const { return version; }
+    int getCutsComputed() const { return cutsComputed; }
+    
+    // Максимальный поток между вершинами: наименьший вес на пути в дереве
+    double query(int s, int t) const {
+        double result = numeric_limits<double>::infinity();
+        while (s != t) {
+            if (depth[s] >= depth[t]) {
+                result = min(result, weight[s]);
+                s = parent[s];
+            } else {
+                result = min(result, weight[t]);
+                t = parent[t];
+            }
+        }
+        return result;
+    }
+};
+
+// Недопоставка потребителю или неизрасходованная закачка источника
+struct StationShortfall {
+    int stationId;
+    double amount;
+};
+
+struct SupplyDemandResult {
+    double totalSupply = 0;               // суммарная закачка источников
+    double totalDemand = 0;               // суммарный отбор потребителей
+    double delivered = 0;                 // доставлено потребителям
+    vector<StationShortfall> unmetDemand; // недопоставка по КС, по убыванию
+    vector<StationShortfall> unusedSupply;// невостребованная закачка по КС, по убыванию
+    vector<double> pipeFlow;              // поток по трубе, индекс - ID трубы
+};
+
+// Допустимость режима с многими источниками и потребителями: сверхисточник
+// соединяется с каждой КС-источником ребром емкостью ее закачки, каждая КС-потребитель -
+// со сверхстоком ребром емкостью ее отбора. Один расчет максимального потока
+// (сведение циркуляции с запросами вершин) вместо расчета на каждую пару КС;
+// недопоставка КС - ненасыщенная часть ее ребра к сверхстоку.
+class SupplyDemandSolver {
+public:
+    static constexpr int SUPER_SOURCE_ID = -1;
+    static constexpr int SUPER_SINK_ID = -2;
+    
+    // balances - пары (ID КС, баланс); КС вне графа сети не получают и не отдают поток
+    static SupplyDemandResult solve(const NetworkGraph& g, const vector<pair<int, double>>& balances) {
+        const double eps = 1e-9;
+        SupplyDemandResult result;
+        NetworkGraph extended = g;
+        int source = extended.addAuxiliaryNode(SUPER_SOURCE_ID);
+        int sink = extended.addAuxiliaryNode(SUPER_SINK_ID);
+        
+        // Ребра терминалов получают ID за пределами ID труб
+        int terminalId = g.pipeIdLimit();
+        vector<int> terminalArcs(balances.size(), -1);
+        for (size_t i = 0; i < balances.size(); ++i) {
+            auto [stationId, balance] = balances[i];
+            if (balance > 0) result.totalSupply += balance;
+            else result.totalDemand -= balance;
+            if (balance == 0 || g.nodeIndex(stationId) == -1) continue;
+            
+            GraphDelta delta = balance > 0 ?
+                GraphDelta{ARC_ADDED, terminalId, SUPER_SOURCE_ID, stationId, balance, 0.0} :
+                GraphDelta{ARC_ADDED, terminalId, stationId, SUPER_SINK_ID, -balance, 0.0};
+            extended.applyDelta(delta, g.getVersion());
+            terminalArcs[i] = terminalId++;
+        }
+        
+        MaxFlowResult flow = MaxFlowSolver(extended, source, sink).run(PUSH_RELABEL);
+        result.delivered = flow.value;
+        for (size_t i = 0; i < balances.size(); ++i) {
+            auto [stationId, balance] = balances[i];
+            if (balance == 0) continue;
+            double used = terminalArcs[i] == -1 ? 0.0 : flow.pipeFlow[terminalArcs[i]];
+            double remaining = fabs(balance) - used;
+            if (remaining <= eps * max(1.0, fabs(balance))) continue;
+            (balance > 0 ? result.unusedSupply : result.unmetDemand).push_back({stationId, remaining});
+        }
+        
+        auto byAmount = [](const StationShortfall& x, const StationShortfall& y) {
+            return x.amount != y.amount ? x.amount > y.amount : x.stationId < y.stationId;
+        };
+        sort(result.unmetDemand.begin(), result.unmetDemand.end(), byAmount);
+        sort(result.unusedSupply.begin(), result.unusedSupply.end(), byAmount);
+        flow.pipeFlow.resize(g.pipeIdLimit());
+        result.pipeFlow = move(flow.pipeFlow);
+        return result;
+    }
+};
+
+// Алгоритмы расчета потока минимальной стоимости
+enum MinCostFlowAlgorithm {
+    SUCCESSIVE_SHORTEST_PATHS,
+    COST_SCALING
+};
+
+// Результат расчета потока минимальной стоимости (стоимость единицы потока - длина трубы)
+struct MinCostFlowResult {
+    double value = 0;         // доставленный объем
+    double cost = 0;          // суммарная стоимость: поток * длина по всем трубам
+    vector<double> arcFlow;   // поток по каждому ребру графа (обратные ребра - с минусом)
+    vector<double> pipeFlow;  // поток по трубе, индекс - ID трубы
+    int iterations = 0;       // увеличивающих путей или фаз масштабирования
+};
+
+// Поток заданного объема из источника в сток с минимальной стоимостью.
+// Последовательные кратчайшие пути: Дейкстра по приведенным стоимостям с
+// потенциалами Джонсона (стоимости неотрицательны, начальные потенциалы нулевые).
+// Масштабирование стоимостей (Голдберг-Тарьян): проталкивание-поднятие с
+// eps-оптимальными ценами, eps уменьшается в ALPHA раз за фазу. Стоимости
+// округляются до целых метров (llround(км * 1000)) и умножаются на n + 1: у
+// 1-оптимального потока любой остаточный цикл (не больше n ребер) стоит больше
+// -1 м, то есть не меньше нуля. Поэтому поток оптимален только для длин труб,
+// округленных до метра. Если цены могут выйти за long long (очень длинные трубы)
+// или избыток вершины остался без выхода (погрешность округления потока),
+// результат считается последовательными кратчайшими путями.
+class MinCostFlowSolver {
+private:
+    static constexpr double EPS = 1e-9;
+    static constexpr long long ALPHA = 8;
+    
+    const NetworkGraph& g;
+    int n;
+    int source;
+    int sink;
+    vector<double> flow;
+    
+    double residual(int a) const {
+        return g.arc(a).capacity - flow[a];
+    }
+    
+    void push(int a, double amount) {
+        flow[a] += amount;
+        flow[g.arc(a).rev] -= amount;
+    }
+    
+    // Стоимость единицы потока по ребру (обратное ребро - со знаком минус)
+    double arcCost(int a) const {
+        const GraphEdge& e = g.arc(a);
+        if (e.weight == numeric_limits<double>::infinity()) return 0.0;
+        return e.forward ? e.weight : -e.weight;
+    }
+    
+    int successiveShortestPaths(double demand) {
+        vector<double> potential(n, 0.0), dist(n);
+        vector<int> parentArc(n);
+        QuaternaryHeap heap;
+        int iterations = 0;
+        double delivered = 0;
+        
+        while (demand - delivered > EPS) {
+            fill(dist.begin(), dist.end(), numeric_limits<double>::infinity());
+            heap.reset(n);
+            dist[source] = 0;
+            heap.update(source, 0);
+            while (!heap.empty()) {
+                int u = heap.pop();
+                if (u == sink) break;
+                for (int a = g.arcsBegin(u); a < g.arcsEnd(u); ++a) {
+                    if (residual(a) <= EPS) continue;
+                    int v = g.arc(a).to;
+                    double reduced = max(0.0, arcCost(a) + potential[u] - potential[v]);
+                    if (dist[u] + reduced < dist[v]) {
+                        dist[v] = dist[u] + reduced;
+                        parentArc[v] = a;
+                        heap.update(v, dist[v]);
+                    }
+                }
+            }
+            if (dist[sink] == numeric_limits<double>::infinity()) break;
+            
+            // Вершины дальше стока получают его расстояние: приведенные стоимости остаются неотрицательными
+            for (int v = 0; v < n; ++v) potential[v] += min(dist[v], dist[sink]);
+            
+            double amount = demand - delivered;
+            for (int v = sink; v != source; v = g.tail(parentArc[v])) {
+                amount = min(amount, residual(parentArc[v]));
+            }
+            for (int v = sink; v != source; v = g.tail(parentArc[v])) push(parentArc[v], amount);
+            delivered += amount;
+            ++iterations;
+        }
+        return iterations;
+    }
+    
+    // Число фаз или -1, если масштабирование неприменимо и поток нужно
+    // пересчитать последовательными кратчайшими путями
+    int costScaling(double demand) {
+        // Цены за все фазы остаются в пределах нескольких n * maxCost:
+        // масштабированная стоимость ребра ограничена с запасом
+        const double costLimit = numeric_limits<long long>::max() / (16.0 * (n + 1));
+        for (int u = 0; u < n; ++u) {
+            for (int a = g.arcsBegin(u); a < g.arcsEnd(u); ++a) {
+                if (fabs(arcCost(a)) * 1000.0 * (n + 1) > costLimit) return -1;
+            }
+        }
+        
+        // Допустимый объем: не больше максимального потока
+        demand = min(demand, MaxFlowSolver(g, source, sink).run(DINIC).value);
+        double tolerance = EPS * max(1.0, demand);
+        
+        vector<long long> cost(g.arcCount(), 0);
+        long long maxCost = 1;
+        for (int u = 0; u < n; ++u) {
+            for (int a = g.arcsBegin(u); a < g.arcsEnd(u); ++a) {
+                cost[a] = llround(arcCost(a) * 1000.0) * (n + 1);
+                maxCost = max(maxCost, llabs(cost[a]));
+            }
+        }
+        
+        long long epsilon = maxCost;
+        vector<long long> price(n, 0);
+        vector<double> excess(n, 0.0);
+        vector<int> current(n);
+        vector<char> queued(n, 0);
+        deque<int> active;
+        excess[source] = demand;
+        excess[sink] = -demand;
+        auto reduced = [&](int u, int a) {
+            return cost[a] + price[u] - price[g.arc(a).to];
+        };
+        auto activate = [&](int v) {
+            if (!queued[v] && excess[v] > tolerance) {
+                queued[v] = 1;
+                active.push_back(v);
+            }
+        };
+        auto pushArc = [&](int u, int a, double amount) {
+            push(a, amount);
+            excess[u] -= amount;
+            excess[g.arc(a).to] += amount;
+        };
+        
+        // Глобальное обновление цен: обратный поиск от вершин с недостатком по
+        // остаточной сети, длина ребра - приведенная стоимость в единицах eps.
+        // Цена вершины снижается на eps * расстояние, eps-оптимальность сохраняется,
+        // а от вершин с избытком появляются допустимые пути к недостатку.
+        vector<long long> rank(n);
+        QuaternaryHeap heap;
+        auto globalUpdate = [&]() {
+            const long long unreached = numeric_limits<long long>::max();
+            fill(rank.begin(), rank.end(), unreached);
+            heap.reset(n);
+            int remaining = 0;
+            for (int v = 0; v < n; ++v) {
+                if (excess[v] < -tolerance) {
+                    rank[v] = 0;
+                    heap.update(v, 0);
+                } else if (excess[v] > tolerance) {
+                    ++remaining;
+                }
+            }
+            long long last = 0;
+            while (!heap.empty() && remaining > 0) {
+                int v = heap.pop();
+                last = rank[v];
+                if (excess[v] > tolerance) --remaining;
+                for (int b = g.arcsBegin(v); b < g.arcsEnd(v); ++b) {
+                    int a = g.arc(b).rev;
+                    int u = g.arc(b).to;
+                    if (residual(a) <= EPS) continue;
+                    long long next = last + max(0LL, (reduced(u, a) + epsilon) / epsilon);
+                    if (next < rank[u]) {
+                        rank[u] = next;
+                        heap.update(u, next);
+                    }
+                }
+            }
+            for (int v = 0; v < n; ++v) {
+                price[v] -= epsilon * min(rank[v], last);
+                current[v] = g.arcsBegin(v);
+            }
+        };
+        
+        int phases = 0;
+        do {
+            epsilon = max(1LL, epsilon / ALPHA);
+            ++phases;
+            
+            // Насыщение ребер с отрицательной приведенной стоимостью: поток 0-оптимален
+            for (int u = 0; u < n; ++u) {
+                for (int a = g.arcsBegin(u); a < g.arcsEnd(u); ++a) {
+                    if (residual(a) > EPS && reduced(u, a) < 0) pushArc(u, a, residual(a));
+                }
+            }
+            for (int u = 0; u < n; ++u) activate(u);
+            globalUpdate();
+            
+            int relabels = 0;
+            while (!active.empty()) {
+                int u = active.front();
+                active.pop_front();
+                queued[u] = 0;
+                while (excess[u] > tolerance) {
+                    if (current[u] == g.arcsEnd(u)) {
+                        // Поднятие: цена на eps ниже наименьшей допустимой
+                        long long best = numeric_limits<long long>::min();
+                        for (int a = g.arcsBegin(u); a < g.arcsEnd(u); ++a) {
+                            if (residual(a) > EPS) best = max(best, price[g.arc(a).to] - cost[a]);
+                        }
+                        // Избыток без выхода: отбросить его - нарушить сохранение потока
+                        if (best == numeric_limits<long long>::min()) return -1;
+                        price[u] = best - epsilon;
+                        current[u] = g.arcsBegin(u);
+                        if (++relabels % n == 0) globalUpdate();
+                        continue;
+                    }
+                    int a = current[u];
+                    if (residual(a) > EPS && reduced(u, a) < 0) {
+                        int v = g.arc(a).to;
+                        pushArc(u, a, min(excess[u], residual(a)));
+                        activate(v);
+                    } else {
+                        ++current[u];
+                    }
+                }
+            }
+        } while (epsilon > 1);
+        return phases;
+    }
+
+public:
+    MinCostFlowSolver(const NetworkGraph& graph, int sourceIndex, int sinkIndex)
+        : g(graph), n(graph.nodeCount()), source(sourceIndex), sink(sinkIndex) {}
+    
+    // demand - требуемый объем (бесконечность - максимальный поток минимальной стоимости)
+    MinCostFlowResult run(MinCostFlowAlgorithm algorithm, double demand) {
+        flow.assign(g.arcCount(), 0.0);
+        MinCostFlowResult result;
+        if (source != sink && demand > 0) {
+            switch (algorithm) {
+                case SUCCESSIVE_SHORTEST_PATHS: result.iterations = successiveShortestPaths(demand); break;
+                case COST_SCALING:
+                    result.iterations = costScaling(demand);
+                    if (result.iterations == -1) {
+                        flow.assign(g.arcCount(), 0.0);
+                        result.iterations = successiveShortestPaths(demand);
+                    }
+                    break;
+            }
+        }
+        
+        for (int a = g.arcsBegin(source); a < g.arcsEnd(source); ++a) result.value += flow[a];
+        for (int u = 0; u < n; ++u) {
+            for (int a = g.arcsBegin(u); a < g.arcsEnd(u); ++a) {
+                if (g.arc(a).forward && flow[a] > 0) result.cost += flow[a] * arcCost(a);
+            }
+        }
+        result.pipeFlow = MaxFlowSolver::pipeFlows(g, flow);
+        result.arcFlow = move(flow);
+        return result;
+    }
+};
+
+// Разреженное разложение LDL^T симметричной положительно определенной матрицы.
+// analyze: порядок исключения вложенными сечениями (подграф делится уровнем
+// поиска в ширину, части нумеруются раньше разделителя) и портрет L по дереву
+// исключения. Портрет зависит только от структуры матрицы, поэтому factor
+// с новыми значениями не повторяет анализ.
+// Столбцы L хранятся в CSC в порядке исключения, строки - по возрастанию.
+// Соседние столбцы с вложенными портретами объединяются в суперузлы: вклад
+// суперузла в столбец копится плотными проходами и разносится один раз.
+class SparseLDLT {
+private:
+    // Подграфы не больше этого размера не делятся и нумеруются в порядке обхода
+    static constexpr int DISSECTION_LEAF = 16;
+    
+    int n = 0;
+    vector<int> order;     // позиция в порядке исключения -> вершина
+    vector<int> position;  // вершина -> позиция
+    vector<int> columnStart;
+    vector<int> rows;
+    vector<int> superStart;  // первый столбец суперузла (размер - число суперузлов + 1)
+    vector<int> rowStart;    // строки L по суперузлам: суперузлы со столбцами j < k, L(k, j) != 0
+    vector<int> rowSupers;
+    vector<int> superNext;   // следующая строка под суперузлом при разложении
+    vector<int> superMark;
+    vector<int> local;       // строка -> строка панели текущего суперузла
+    vector<double> values;
+    vector<double> pivots;   // D
+    vector<double> work;
+    vector<double> panel;    // плотные столбцы текущего суперузла
+    vector<double> update;   // вклад суперузла в блок столбцов панели
+    
+    // Порядок вложенных сечений по графу смежности adjStart/adjacency
+    void orderByDissection(const vector<int>& adjStart, const vector<int>& adjacency) {
+        vector<int> group(n, -1), level(n, -1);
+        int groups = 0;
+        order.clear();
+        
+        // Обход в ширину внутри группы id; levelSizes - число вершин на уровнях
+        vector<int> visited, levelSizes;
+        auto bfs = [&](int start, int id) {
+            visited.clear();
+            levelSizes.clear();
+            level[start] = 0;
+            visited.push_back(start);
+            for (size_t head = 0; head < visited.size(); ++head) {
+                int u = visited[head];
+                if (level[u] == static_cast<int>(levelSizes.size())) levelSizes.push_back(0);
+                levelSizes[level[u]]++;
+                for (int e = adjStart[u]; e < adjStart[u + 1]; ++e) {
+                    int w = adjacency[e];
+                    if (group[w] == id && level[w] == -1) {
+                        level[w] = level[u] + 1;
+                        visited.push_back(w);
+                    }
+                }
+            }
+            for (int u : visited) level[u] = -1;
+        };
+        
+        // Задача: разделить множество вершин или (emit) вывести его в порядок.
+        // Стек дает порядок: первая часть, вторая часть, разделитель
+        vector<pair<vector<int>, bool>> tasks;
+        vector<int> all(n);
+        iota(all.begin(), all.end(), 0);
+        tasks.push_back({move(all), false});
+        while (!tasks.empty()) {
+            auto [vertices, emit] = move(tasks.back());
+            tasks.pop_back();
+            if (emit || static_cast<int>(vertices.size()) <= DISSECTION_LEAF) {
+                order.insert(order.end(), vertices.begin(), vertices.end());
+                continue;
+            }
+            int id = groups++;
+            for (int v : vertices) group[v] = id;
+            
+            // Почти периферийная вершина - последняя в обходе
+            bfs(vertices[0], id);
+            if (visited.size() < vertices.size()) {
+                // Несвязное множество: компонента отделяется без разделителя
+                vector<int> rest;
+                for (int v : vertices) group[v] = -1;
+                for (int v : visited) group[v] = id;
+                for (int v : vertices) {
+                    if (group[v] != id) rest.push_back(v);
+                }
+                tasks.push_back({move(rest), false});
+                tasks.push_back({visited, false});
+                continue;
+            }
+            bfs(visited.back(), id);
+            
+            // Разделитель - самый малый уровень, по обе стороны которого остается
+            // не меньше трети вершин (если такого нет - уровень середины)
+            int total = vertices.size(), separatorLevel = -1;
+            for (int l = 0, before = 0; l < static_cast<int>(levelSizes.size()); before += levelSizes[l++]) {
+                int after = total - before - levelSizes[l];
+                bool balanced = 3 * before >= total && 3 * after >= total;
+                if (balanced && (separatorLevel == -1 || levelSizes[l] < levelSizes[separatorLevel])) separatorLevel = l;
+            }
+            if (separatorLevel == -1) {
+                separatorLevel = 0;
+                for (int count = 0; count + levelSizes[separatorLevel] <= total / 2; ++separatorLevel) {
+                    count += levelSizes[separatorLevel];
+                }
+            }
+            vector<int> first, second, separator;
+            size_t index = 0;
+            for (int l = 0; l < static_cast<int>(levelSizes.size()); ++l) {
+                for (int i = 0; i < levelSizes[l]; ++i) level[visited[index++]] = l;
+            }
+            for (int u : visited) {
+                if (level[u] < separatorLevel) {
+                    first.push_back(u);
+                } else if (level[u] > separatorLevel) {
+                    second.push_back(u);
+                } else {
+                    // Вершина без соседей за разделителем переходит в первую часть
+                    bool touchesSecond = false;
+                    for (int e = adjStart[u]; e < adjStart[u + 1] && !touchesSecond; ++e) {
+                        int w = adjacency[e];
+                        touchesSecond = group[w] == id && level[w] > separatorLevel;
+                    }
+                    (touchesSecond ? separator : first).push_back(u);
+                }
+            }
+            for (int u : visited) level[u] = -1;
+            if (second.empty()) {
+                // Уровней слишком мало для деления (например, звезда)
+                order.insert(order.end(), visited.begin(), visited.end());
+                continue;
+            }
+            tasks.push_back({move(separator), true});
+            tasks.push_back({move(second), false});
+            tasks.push_back({move(first), false});
+        }
+    }
+
+public:
+    // edges - внедиагональные ненулевые элементы (пары вершин, повторы допустимы)
+    void analyze(int size, const vector<pair<int, int>>& edges) {
+        n = size;
+        vector<int> adjStart(n + 1, 0);
+        for (const auto& [u, v] : edges) {
+            if (u == v) continue;
+            adjStart[u + 1]++;
+            adjStart[v + 1]++;
+        }
+        for (int v = 0; v < n; ++v) adjStart[v + 1] += adjStart[v];
+        vector<int> adjacency(adjStart[n]);
+        vector<int> cursor(adjStart.begin(), adjStart.end() - 1);
+        for (const auto& [u, v] : edges) {
+            if (u == v) continue;
+            adjacency[cursor[u]++] = v;
+            adjacency[cursor[v]++] = u;
+        }
+        
+        orderByDissection(adjStart, adjacency);
+        position.assign(n, 0);
+        for (int k = 0; k < n; ++k) position[order[k]] = k;
+        
+        // Строка k портрета L - вершины путей дерева исключения от соседей
+        // с меньшей позицией до k; родитель столбца - первая строка под диагональю
+        vector<int> parent(n, -1), mark(n, -1);
+        vector<int> patternStart(n + 1, 0), patternColumns;
+        for (int k = 0; k < n; ++k) {
+            mark[k] = k;
+            int v = order[k];
+            for (int e = adjStart[v]; e < adjStart[v + 1]; ++e) {
+                for (int j = position[adjacency[e]]; j < k && mark[j] != k; j = parent[j]) {
+                    patternColumns.push_back(j);
+                    mark[j] = k;
+                    if (parent[j] == -1) parent[j] = k;
+                }
+            }
+            patternStart[k + 1] = patternColumns.size();
+        }
+        
+        // Столбцы L: строки заполняются по возрастанию k
+        columnStart.assign(n + 1, 0);
+        for (int j : patternColumns) columnStart[j + 1]++;
+        for (int k = 0; k < n; ++k) columnStart[k + 1] += columnStart[k];
+        rows.resize(patternColumns.size());
+        cursor.assign(columnStart.begin(), columnStart.end() - 1);
+        for (int k = 0; k < n; ++k) {
+            for (int r = patternStart[k]; r < patternStart[k + 1]; ++r) rows[cursor[patternColumns[r]]++] = k;
+        }
+        
+        // Суперузел продолжается столбцом k, если портрет k - 1 равен {k} и портрету k
+        superStart.clear();
+        vector<int> superOf(n);
+        for (int k = 0; k < n; ++k) {
+            int count = columnStart[k] - (k > 0 ? columnStart[k - 1] : 0);
+            bool extends = k > 0 && count == columnStart[k + 1] - columnStart[k] + 1 && rows[columnStart[k - 1]] == k;
+            if (!extends) superStart.push_back(k);
+            superOf[k] = superStart.size() - 1;
+        }
+        superStart.push_back(n);
+        
+        // Строка k содержит все столбцы суперузла левее k, поэтому хранится списком суперузлов
+        rowStart.assign(n + 1, 0);
+        rowSupers.clear();
+        cursor.assign(superStart.size(), -1);
+        for (int k = 0; k < n; ++k) {
+            for (int r = patternStart[k]; r < patternStart[k + 1]; ++r) {
+                int super = superOf[patternColumns[r]];
+                if (cursor[super] != k) {
+                    cursor[super] = k;
+                    rowSupers.push_back(super);
+                }
+            }
+            rowStart[k + 1] = rowSupers.size();
+        }
+        superNext.assign(superStart.size() - 1, 0);
+        superMark.assign(superStart.size() - 1, -1);
+        size_t panelSize = 0;
+        for (size_t s = 0; s + 1 < superStart.size(); ++s) {
+            size_t width = superStart[s + 1] - superStart[s];
+            panelSize = max(panelSize, width * (1 + columnStart[superStart[s] + 1] - columnStart[superStart[s]]));
+        }
+        
+        values.assign(rows.size(), 0.0);
+        pivots.assign(n, 0.0);
+        work.assign(n, 0.0);
+        local.assign(n, 0);
+        panel.assign(panelSize, 0.0);
+        update.assign(static_cast<size_t>(n) * 4, 0.0);
+    }
+    
+    int size() const { return n; }
+    long long nonzeros() const { return rows.size(); }
+    
+    // Индекс внедиагонального элемента (u, v) в массиве значений матрицы
+    // (элементы матрицы и L имеют общий портрет)
+    int slot(int u, int v) const {
+        int j = min(position[u], position[v]);
+        int i = max(position[u], position[v]);
+        return lower_bound(rows.begin() + columnStart[j], rows.begin() + columnStart[j + 1], i) - rows.begin();
+    }
+    
+    // diagonal - диагональ по вершинам, offDiagonal - элементы по индексам slot.
+    // Возвращает false, если матрица не положительно определена.
+    // Столбцы суперузла раскладываются вместе в плотной панели (строки - его
+    // столбцы и общий портрет под ними); вклад каждого предыдущего суперузла
+    // считается блоками по BLOCK столбцов панели, так что его значения читаются
+    // из памяти один раз на блок, а не на каждый столбец.
+    bool factor(const vector<double>& diagonal, const vector<double>& offDiagonal) {
+        constexpr int BLOCK = 4;
+        fill(superNext.begin(), superNext.end(), 0);
+        fill(superMark.begin(), superMark.end(), -1);
+        for (int super = 0; super + 1 < static_cast<int>(superStart.size()); ++super) {
+            int first = superStart[super], end = superStart[super + 1];
+            int width = end - first;
+            int height = 1 + columnStart[first + 1] - columnStart[first];
+            for (int k = first; k < end; ++k) local[k] = k - first;
+            for (int s = columnStart[end - 1]; s < columnStart[end]; ++s) local[rows[s]] = width + s - columnStart[end - 1];
+            
+            double* panel = this->panel.data();
+            fill(panel, panel + static_cast<size_t>(height) * width, 0.0);
+            for (int c = 0; c < width; ++c) {
+                double* column = panel + static_cast<size_t>(c) * height;
+                column[c] = diagonal[order[first + c]];
+                for (int s = columnStart[first + c]; s < columnStart[first + c + 1]; ++s) {
+                    column[local[rows[s]]] = offDiagonal[s];
+                }
+            }
+            
+            // Вклад предыдущих суперузлов: строки source с номерами из [first, end)
+            // идут подряд с superNext[source], ниже них - остальные строки панели
+            for (int r = rowStart[first]; r < rowStart[end]; ++r) {
+                int source = rowSupers[r];
+                if (source == super || superMark[source] == super) continue;
+                superMark[source] = super;
+                int sourceFirst = superStart[source], sourceEnd = superStart[source + 1];
+                int below = columnStart[sourceEnd] - columnStart[sourceEnd - 1];
+                int length = below - superNext[source];
+                const int* target = rows.data() + columnStart[sourceEnd] - length;
+                int targets = 0;
+                while (targets < length && target[targets] < end) ++targets;
+                superNext[source] += targets;
+                
+                for (int t0 = 0; t0 < targets; t0 += BLOCK) {
+                    int block = min(BLOCK, targets - t0);
+                    fill(update.begin(), update.begin() + static_cast<size_t>(length) * BLOCK, 0.0);
+                    double* sum = update.data();
+                    int j = sourceFirst;
+                    if (block == BLOCK) {
+                        // По четыре столбца source за проход: блок вклада остается в регистрах
+                        for (; j + 4 <= sourceEnd; j += 4) {
+                            const double* c0 = values.data() + columnStart[j + 1] - length;
+                            const double* c1 = values.data() + columnStart[j + 2] - length;
+                            const double* c2 = values.data() + columnStart[j + 3] - length;
+                            const double* c3 = values.data() + columnStart[j + 4] - length;
+                            double s0[BLOCK], s1[BLOCK], s2[BLOCK], s3[BLOCK];
+                            for (int b = 0; b < BLOCK; ++b) {
+                                s0[b] = pivots[j] * c0[t0 + b];
+                                s1[b] = pivots[j + 1] * c1[t0 + b];
+                                s2[b] = pivots[j + 2] * c2[t0 + b];
+                                s3[b] = pivots[j + 3] * c3[t0 + b];
+                            }
+                            for (int i = t0; i < length; ++i) {
+                                for (int b = 0; b < BLOCK; ++b) {
+                                    sum[i * BLOCK + b] += s0[b] * c0[i] + s1[b] * c1[i] + s2[b] * c2[i] + s3[b] * c3[i];
+                                }
+                            }
+                        }
+                    }
+                    for (; j < sourceEnd; ++j) {
+                        const double* column = values.data() + columnStart[j + 1] - length;
+                        for (int b = 0; b < block; ++b) {
+                            double scaled = pivots[j] * column[t0 + b];
+                            for (int i = t0 + b; i < length; ++i) sum[i * BLOCK + b] += scaled * column[i];
+                        }
+                    }
+                    for (int b = 0; b < block; ++b) {
+                        double* column = panel + static_cast<size_t>(local[target[t0 + b]]) * height;
+                        for (int i = t0 + b; i < length; ++i) column[local[target[i]]] -= sum[i * BLOCK + b];
+                    }
+                }
+            }
+            
+            // Плотное разложение панели
+            for (int c = 0; c < width; ++c) {
+                double* column = panel + static_cast<size_t>(c) * height;
+                for (int b = 0; b < c; ++b) {
+                    const double* previous = panel + static_cast<size_t>(b) * height;
+                    double scaled = pivots[first + b] * previous[c];
+                    for (int i = c; i < height; ++i) column[i] -= scaled * previous[i];
+                }
+                double pivot = column[c];
+                if (!(pivot > 0)) return false;
+                pivots[first + c] = pivot;
+                double* out = values.data() + columnStart[first + c];
+                for (int i = c + 1; i < height; ++i) {
+                    column[i] /= pivot;
+                    out[i - c - 1] = column[i];
+                }
+            }
+        }
+        return true;
+    }
+    
+    // Решение A x = b на месте (индексы - исходные вершины)
+    void solve(vector<double>& x) {
+        vector<double>& y = work;
+        for (int k = 0; k < n; ++k) y[k] = x[order[k]];
+        for (int k = 0; k < n; ++k) {
+            for (int s = columnStart[k]; s < columnStart[k + 1]; ++s) y[rows[s]] -= values[s] * y[k];
+        }
+        for (int k = 0; k < n; ++k) y[k] /= pivots[k];
+        for (int k = n - 1; k >= 0; --k) {
+            for (int s = columnStart[k]; s < columnStart[k + 1]; ++s) y[k] -= values[s] * y[rows[s]];
+        }
+        for (int k = 0; k < n; ++k) {
+            x[order[k]] = y[k];
+            y[k] = 0;
+        }
+    }
+};
+
+// Результат гидравлического расчета установившегося режима
+struct HydraulicResult {
+    bool converged = false;
+    int iterations = 0;            // итерации Ньютона
+    double residual = 0;           // наибольшая невязка закона трубы по квадратам давлений, МПа^2
+    vector<double> squaredPressure;// квадрат давления узла, МПа^2 (NaN - нет связи с источником)
+    vector<double> nodeOutflow;    // отток из узла (для узлов с заданным давлением - подача)
+    vector<double> pipeFlow;       // расход по трубе по ее направлению, индекс - ID трубы
+    bool symbolicReused = false;   // портрет разложения взят из предыдущего расчета
+    long long factorNonzeros = 0;  // ненулевых элементов L
+    double analyzeMs = 0;          // упорядочение и символьное разложение
+    double factorMs = 0;           // численные разложения и решения за все итерации
+};
+
+// Узловой гидравлический расчет газовой сети. Связь расхода трубы с квадратами
+// давлений (формула Веймаута): dP2 = q * |q| / C^2, C - проводимость трубы;
+// около нуля закон сглажен: dP2 = q * sqrt(q^2 + f^2) / C^2, f - малый расход.
+// Градиентный метод (Ньютон по расходам и квадратам давлений одновременно):
+// закон трубы линеаризуется по расходу, расходы исключаются, и на каждой
+// итерации решается узловая система A D^-1 A^T pi = b (A - матрица инциденций,
+// D - диагональ производных dP2 по расходу). Балансы узлов выполняются точно
+// на каждой итерации, а у потери давления, в отличие от расхода как функции
+// перепада, производная ограничена около нулевого расхода. Матрица
+// симметрична и положительно определена, поэтому решается разложением LDL^T
+// без выбора ведущего элемента. Портрет разложения сохраняется между
+// расчетами и пересчитывается только при изменении структуры сети или узлов
+// с заданным давлением; трубы в ремонте остаются в портрете с нулевой проводимостью.
+class HydraulicSolver {
+private:
+    // Расход сглаживания f (доля наибольшего притока узла): у труб почти без
+    // расхода элементы матрицы остаются конечными и ошибки округления малы
+    static constexpr double FLOW_FLOOR = 1e-5;
+    
+    SparseLDLT ldlt;
+    vector<int> pipeTails, pipeHeads;  // структура, для которой построен портрет
+    vector<char> fixedNodes;
+    vector<int> freeIndex;             // узел -> номер неизвестной (-1 - давление задано)
+    vector<int> pipeSlots;             // элемент матрицы трубы (-1, если один из концов задан)
+    
+    // Потеря dP2 трубы с c2 = C^2 при расходе q
+    static double lossOf(double c2, double q, double floor) {
+        return q * sqrt(q * q + floor * floor) / c2;
+    }
+    
+    // Обратная функция: расход при перепаде drop
+    static double flowOf(double c2, double drop, double floor) {
+        double y = drop * c2;
+        double f2 = floor * floor;
+        return copysign(sqrt(2 * y * y / (sqrt(f2 * f2 + 4 * y * y) + f2)), drop);
+    }
+
+public:
+    // conductance - проводимость по ID трубы (0 - труба в ремонте),
+    // injection - приток в узел (отбор - отрицательный), fixed - узлы с заданным давлением
+    HydraulicResult solve(const NetworkGraph& g, const vector<double>& conductance,
+                          const vector<double>& injection, const vector<char>& fixed,
+                          double fixedPressure, int maxIterations = 50) {
+        return solve(g, conductance, injection, fixed, vector<double>(g.nodeCount(), fixedPressure), maxIterations);
+    }
+    
+    // То же с давлением по узлам: nodePressure[u] задано для узлов с fixed[u]
+    HydraulicResult solve(const NetworkGraph& g, const vector<double>& conductance,
+                          const vector<double>& injection, const vector<char>& fixed,
+                          const vector<double>& nodePressure, int maxIterations = 50) {
+        HydraulicResult result;
+        int n = g.nodeCount();
+        double fixedPressure = 0;
+        for (int u = 0; u < n; ++u) {
+            if (fixed[u]) fixedPressure = max(fixedPressure, nodePressure[u]);
+        }
+        vector<int> tails, heads, pipeIds;
+        for (int u = 0; u < n; ++u) {
+            for (int a = g.arcsBegin(u); a < g.arcsEnd(u); ++a) {
+                const GraphEdge& e = g.arc(a);
+                if (!e.forward || e.pipeId < 0) continue;
+                tails.push_back(u);
+                heads.push_back(e.to);
+                pipeIds.push_back(e.pipeId);
+            }
+        }
+        int m = pipeIds.size();
+        
+        // Символьный анализ только при изменении структуры
+        auto analyzeStart = chrono::steady_clock::now();
+        result.symbolicReused = tails == pipeTails && heads == pipeHeads && fixed == fixedNodes;
+        if (!result.symbolicReused) {
+            pipeTails = tails;
+            pipeHeads = heads;
+            fixedNodes = fixed;
+            freeIndex.assign(n, -1);
+            int unknowns = 0;
+            for (int u = 0; u < n; ++u) {
+                if (!fixed[u]) freeIndex[u] = unknowns++;
+            }
+            vector<pair<int, int>> edges;
+            for (int p = 0; p < m; ++p) {
+                int fu = freeIndex[tails[p]], fv = freeIndex[heads[p]];
+                if (fu != -1 && fv != -1 && fu != fv) edges.push_back({fu, fv});
+            }
+            ldlt.analyze(unknowns, edges);
+            pipeSlots.assign(m, -1);
+            for (int p = 0; p < m; ++p) {
+                int fu = freeIndex[tails[p]], fv = freeIndex[heads[p]];
+                if (fu != -1 && fv != -1 && fu != fv) pipeSlots[p] = ldlt.slot(fu, fv);
+            }
+        }
+        result.analyzeMs = chrono::duration<double, milli>(chrono::steady_clock::now() - analyzeStart).count();
+        result.factorNonzeros = ldlt.nonzeros();
+        int unknowns = ldlt.size();
+        
+        vector<double> pipeConductance(m);
+        for (int p = 0; p < m; ++p) {
+            pipeConductance[p] = pipeIds[p] < static_cast<int>(conductance.size()) ? conductance[pipeIds[p]] : 0.0;
+        }
+        
+        // Узлы без пути от узлов с заданным давлением по работающим трубам
+        vector<char> connected(n, 0);
+        vector<vector<int>> incident(n);
+        for (int p = 0; p < m; ++p) {
+            if (pipeConductance[p] <= 0) continue;
+            incident[tails[p]].push_back(heads[p]);
+            incident[heads[p]].push_back(tails[p]);
+        }
+        vector<int> queue;
+        for (int u = 0; u < n; ++u) {
+            if (fixed[u]) {
+                connected[u] = 1;
+                queue.push_back(u);
+            }
+        }
+        for (size_t head = 0; head < queue.size(); ++head) {
+            for (int v : incident[queue[head]]) {
+                if (!connected[v]) {
+                    connected[v] = 1;
+                    queue.push_back(v);
+                }
+            }
+        }
+        
+        double scale = 0;
+        for (int u = 0; u < n; ++u) scale = max(scale, fabs(injection[u]));
+        double floor = FLOW_FLOOR * max(scale, 1.0);
+        double tolerance = 1e-9 * fixedPressure * fixedPressure;
+        vector<double> pressure(n, fixedPressure * fixedPressure);
+        for (int u = 0; u < n; ++u) {
+            if (fixed[u]) pressure[u] = nodePressure[u] * nodePressure[u];
+        }
+        vector<double> flow(m, 0.0), gain(m, 0.0), rhs(unknowns), diagonal(unknowns), offDiagonal(ldlt.nonzeros());
+        
+        // Итерация: D - производная потери по расходу, gain = D^-1; новый расход
+        // трубы q' = q + gain * (dP2 - loss(q)), подставленный в балансы узлов.
+        // Расход, больший по модулю, чем дает закон при текущих давлениях,
+        // заменяется законным: иначе метод Ньютона для q|q| сходится от
+        // завышенного расхода лишь делением пополам
+        result.residual = numeric_limits<double>::infinity();
+        while (result.residual > tolerance && result.iterations < maxIterations) {
+            auto factorStart = chrono::steady_clock::now();
+            fill(diagonal.begin(), diagonal.end(), 0.0);
+            fill(offDiagonal.begin(), offDiagonal.end(), 0.0);
+            for (int u = 0; u < n; ++u) {
+                int fu = freeIndex[u];
+                if (fu != -1) rhs[fu] = connected[u] ? injection[u] : 0.0;
+                if (fu != -1 && !connected[u]) diagonal[fu] = 1.0;
+            }
+            for (int p = 0; p < m; ++p) {
+                if (pipeConductance[p] <= 0 || !connected[tails[p]]) continue;
+                double c2 = pipeConductance[p] * pipeConductance[p];
+                if (result.iterations > 0) {
+                    double drop = pressure[tails[p]] - pressure[heads[p]];
+                    double law = flowOf(c2, drop, floor);
+                    if (fabs(law) < fabs(flow[p])) flow[p] = law;
+                }
+                double q = flow[p], root = sqrt(q * q + floor * floor);
+                gain[p] = c2 * root / (2 * q * q + floor * floor);
+                // q - gain * loss(q): часть нового расхода, не зависящая от давлений
+                double offset = q - gain[p] * lossOf(c2, q, floor);
+                int fu = freeIndex[tails[p]], fv = freeIndex[heads[p]];
+                if (fu != -1) {
+                    diagonal[fu] += gain[p];
+                    rhs[fu] -= offset;
+                    if (fv == -1) rhs[fu] += gain[p] * pressure[heads[p]];
+                }
+                if (fv != -1) {
+                    diagonal[fv] += gain[p];
+                    rhs[fv] += offset;
+                    if (fu == -1) rhs[fv] += gain[p] * pressure[tails[p]];
+                }
+                if (pipeSlots[p] != -1) offDiagonal[pipeSlots[p]] -= gain[p];
+            }
+            if (!ldlt.factor(diagonal, offDiagonal)) break;
+            ldlt.solve(rhs);
+            result.factorMs += chrono::duration<double, milli>(chrono::steady_clock::now() - factorStart).count();
+            
+            for (int u = 0; u < n; ++u) {
+                if (freeIndex[u] != -1) pressure[u] = connected[u] ? rhs[freeIndex[u]] : fixedPressure * fixedPressure;
+            }
+            result.residual = 0;
+            for (int p = 0; p < m; ++p) {
+                if (pipeConductance[p] <= 0 || !connected[tails[p]]) continue;
+                double c2 = pipeConductance[p] * pipeConductance[p];
+                double drop = pressure[tails[p]] - pressure[heads[p]];
+                flow[p] += gain[p] * (drop - lossOf(c2, flow[p], floor));
+                result.residual = max(result.residual, fabs(drop - lossOf(c2, flow[p], floor)));
+            }
+            ++result.iterations;
+        }
+        result.converged = result.residual <= tolerance;
+        
+        result.pipeFlow.assign(g.pipeIdLimit(), 0.0);
+        result.nodeOutflow.assign(n, 0.0);
+        for (int p = 0; p < m; ++p) {
+            result.pipeFlow[pipeIds[p]] = flow[p];
+            result.nodeOutflow[tails[p]] += flow[p];
+            result.nodeOutflow[heads[p]] -= flow[p];
+        }
+        for (int u = 0; u < n; ++u) {
+            if (!connected[u]) pressure[u] = numeric_limits<double>::quiet_NaN();
+        }
+        result.squaredPressure = move(pressure);
+        return result;
+    }
+};
+
+// Состояние сети в момент нестационарного расчета (для сводки)
+struct TransientSnapshot {
+    int minute;
+    double linePack;     // запас газа в трубах, млн м^3
+    double minPressure;  // наименьшее давление узла без заданного давления, МПа
+    double supply;       // подача узлов с заданным давлением, млн м^3/сут
+    double withdrawal;   // отбор потребителей, млн м^3/сут
+};
+
+struct TransientResult {
+    int pipes = 0;
+    int substeps = 0;    // шагов интегрирования на минуту
+    int records = 0;     // записей в файле
+    vector<TransientSnapshot> hourly;
+};
+
+// Нестационарный расчет газовой сети на сутки с шагом в минуту. Газ
+// накапливается в узлах: емкость узла - половина объема примыкающих труб
+// (запас при давлении p равен V * p / p_atm), расход трубы - по формуле
+// Веймаута от давлений на концах, при малом перепаде закон переходит в
+// линейный. Узлы с заданным давлением - граничные, отбор потребителей
+// меняется по суточному графику. Явная схема Эйлера: минута делится на
+// подшаги по условию устойчивости.
+// Состояние хранится структурой массивов (отдельно по трубам и по узлам);
+// каждый этап шага - проход по непрерывным массивам без ветвлений, который
+// компилятор может векторизовать. Записи пишутся в поток сразу.
+// Формат файла: "TRN1", int32 число труб, число записей и интервал записи
+// в минутах, int32 ID труб; запись - int32 минута и float по трубам: давление
+// в начале, давление в конце (МПа), расход (млн м^3/сут), запас газа (млн м^3).
+class TransientSimulator {
+public:
+    static constexpr int HORIZON_MINUTES = 24 * 60;
+
+private:
+    static constexpr double PI = 3.14159265358979323846;
+    static constexpr double ATMOSPHERIC_PRESSURE = 0.101325;  // МПа
+    static constexpr double SMOOTHING = 0.01;                 // МПа^2, граница линейного закона
+    static constexpr double DEMAND_SWING = 0.3;               // размах суточного графика отбора
+    static constexpr double PEAK_HOUR = 18;                   // час наибольшего отбора
+    
+    // По трубам
+    vector<int> tail, head, pipeIds;
+    vector<double> conductance;      // млн м^3/сут при разности квадратов давлений 1 МПа^2
+    vector<double> packPerPressure;  // V / p_atm, млн м^3 на МПа
+    vector<double> inletPressure, outletPressure, flow, linePack;
+    // По узлам
+    vector<double> pressure, inverseCapacity, withdrawal, inflow;
+    vector<char> fixedNode;
+    vector<int> incidentStart, incidentPipe;
+    vector<double> incidentSign;     // +1 - труба входит в узел, -1 - выходит
+    vector<float> buffer;
+    
+    static double demandFactor(double minute) {
+        return 1 + DEMAND_SWING * cos(2 * PI * (minute / 60 - PEAK_HOUR) / 24);
+    }
+    
+    void gatherPressures() {
+        int m = tail.size();
+        for (int p = 0; p < m; ++p) {
+            inletPressure[p] = pressure[tail[p]];
+            outletPressure[p] = pressure[head[p]];
+        }
+    }
+    
+    void computeFlows() {
+        int m = tail.size();
+        for (int p = 0; p < m; ++p) {
+            double x = inletPressure[p] * inletPressure[p] - outletPressure[p] * outletPressure[p];
+            flow[p] = conductance[p] * x / sqrt(fabs(x) + SMOOTHING);
+        }
+    }
+    
+    void computeInflows() {
+        int n = pressure.size();
+        for (int u = 0; u < n; ++u) {
+            double sum = 0;
+            for (int i = incidentStart[u]; i < incidentStart[u + 1]; ++i) sum += incidentSign[i] * flow[incidentPipe[i]];
+            inflow[u] = sum;
+        }
+    }
+    
+    // У узлов с заданным давлением inverseCapacity и withdrawal равны нулю
+    void advanceNodes(double dt, double factor) {
+        int n = pressure.size();
+        for (int u = 0; u < n; ++u) {
+            double next = pressure[u] + dt * (inflow[u] - withdrawal[u] * factor) * inverseCapacity[u];
+            pressure[u] = max(0.0, next);
+        }
+    }
+    
+    void computeLinePack() {
+        int m = tail.size();
+        for (int p = 0; p < m; ++p) linePack[p] = packPerPressure[p] * (inletPressure[p] + outletPressure[p]) / 2;
+    }
+    
+    void evaluate() {
+        gatherPressures();
+        computeFlows();
+        computeInflows();
+    }
+    
+    // После computeLinePack
+    TransientSnapshot snapshot(int minute) const {
+        TransientSnapshot result{minute, 0, numeric_limits<double>::infinity(), 0, 0};
+        for (double pack : linePack) result.linePack += pack;
+        double factor = demandFactor(minute);
+        for (size_t u = 0; u < pressure.size(); ++u) {
+            if (fixedNode[u]) {
+                result.supply -= inflow[u];
+            } else {
+                result.withdrawal += withdrawal[u] * factor;
+                if (incidentStart[u + 1] > incidentStart[u]) result.minPressure = min(result.minPressure, pressure[u]);
+            }
+        }
+        return result;
+    }
+    
+    void writeArray(ostream& out, const vector<double>& values) {
+        for (size_t i = 0; i < values.size(); ++i) buffer[i] = values[i];
+        out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(float));
+    }
+    
+    void writeRecord(ostream& out, int minute) {
+        int32_t value = minute;
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        writeArray(out, inletPressure);
+        writeArray(out, outletPressure);
+        writeArray(out, flow);
+        writeArray(out, linePack);
+    }
+
+public:
+    // Геометрический объем трубы, м^3 (диаметр в мм, длина в км)
+    static double pipeVolume(int diameter, double length) {
+        double radius = diameter / 2000.0;
+        return PI * radius * radius * length * 1000.0;
+    }
+    
+    // conductance и volume (м^3) - по ID трубы; setpoint - давление узла
+    // (NaN - свободный узел), nodeWithdrawal - средний отбор узла,
+    // initial - начальные давления свободных узлов
+    TransientResult run(const NetworkGraph& g, const vector<double>& pipeConductance,
+                        const vector<double>& pipeVolume, const vector<double>& setpoint,
+                        const vector<double>& nodeWithdrawal, const vector<double>& initial,
+                        int recordEvery, ostream& out) {
+        TransientResult result;
+        int n = g.nodeCount();
+        tail.clear();
+        head.clear();
+        pipeIds.clear();
+        conductance.clear();
+        packPerPressure.clear();
+        for (int u = 0; u < n; ++u) {
+            for (int a = g.arcsBegin(u); a < g.arcsEnd(u); ++a) {
+                const GraphEdge& e = g.arc(a);
+                if (!e.forward || e.pipeId < 0) continue;
+                bool known = e.pipeId < static_cast<int>(pipeConductance.size());
+                tail.push_back(u);
+                head.push_back(e.to);
+                pipeIds.push_back(e.pipeId);
+                conductance.push_back(known ? pipeConductance[e.pipeId] : 0.0);
+                packPerPressure.push_back(known ? pipeVolume[e.pipeId] / ATMOSPHERIC_PRESSURE / 1e6 : 0.0);
+            }
+        }
+        int m = tail.size();
+        result.pipes = m;
+        inletPressure.assign(m, 0.0);
+        outletPressure.assign(m, 0.0);
+        flow.assign(m, 0.0);
+        linePack.assign(m, 0.0);
+        buffer.assign(m, 0.0f);
+        
+        incidentStart.assign(n + 1, 0);
+        for (int p = 0; p < m; ++p) {
+            incidentStart[tail[p] + 1]++;
+            incidentStart[head[p] + 1]++;
+        }
+        for (int u = 0; u < n; ++u) incidentStart[u + 1] += incidentStart[u];
+        incidentPipe.assign(incidentStart[n], 0);
+        incidentSign.assign(incidentStart[n], 0.0);
+        vector<int> cursor(incidentStart.begin(), incidentStart.end() - 1);
+        for (int p = 0; p < m; ++p) {
+            incidentPipe[cursor[tail[p]]] = p;
+            incidentSign[cursor[tail[p]]++] = -1;
+            incidentPipe[cursor[head[p]]] = p;
+            incidentSign[cursor[head[p]]++] = 1;
+        }
+        
+        // Емкость узла и граничные условия; шаг по условию устойчивости:
+        // dt * (сумма наибольших производных расходов по давлению) / емкость <= 1
+        pressure.assign(n, 0.0);
+        inverseCapacity.assign(n, 0.0);
+        withdrawal.assign(n, 0.0);
+        inflow.assign(n, 0.0);
+        fixedNode.assign(n, 0);
+        double highest = 0;
+        for (int u = 0; u < n; ++u) {
+            fixedNode[u] = !std::isnan(setpoint[u]);
+            pressure[u] = fixedNode[u] ? setpoint[u] : max(0.0, initial[u]);
+            highest = max(highest, pressure[u]);
+        }
+        double maxRate = 0;
+        for (int u = 0; u < n; ++u) {
+            if (fixedNode[u]) continue;
+            double capacity = 0, stiffness = 0;
+            for (int i = incidentStart[u]; i < incidentStart[u + 1]; ++i) {
+                capacity += packPerPressure[incidentPipe[i]] / 2;
+                stiffness += 2 * highest * conductance[incidentPipe[i]] / sqrt(SMOOTHING);
+            }
+            if (capacity <= 0) continue;
+            inverseCapacity[u] = 1 / capacity;
+            withdrawal[u] = nodeWithdrawal[u];
+            maxRate = max(maxRate, stiffness / capacity);
+        }
+        const double minuteDays = 1.0 / HORIZON_MINUTES;
+        result.substeps = max(1, static_cast<int>(ceil(maxRate * minuteDays)));
+        double dt = minuteDays / result.substeps;
+        
+        result.records = HORIZON_MINUTES / recordEvery + 1;
+        int32_t header[3] = {m, result.records, recordEvery};
+        out.write("TRN1", 4);
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        for (int id : pipeIds) {
+            int32_t value = id;
+            out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+        
+        evaluate();
+        computeLinePack();
+        writeRecord(out, 0);
+        result.hourly.push_back(snapshot(0));
+        for (int minute = 1; minute <= HORIZON_MINUTES; ++minute) {
+            for (int s = 0; s < result.substeps; ++s) {
+                if (s > 0) evaluate();
+                advanceNodes(dt, demandFactor(minute - 1 + static_cast<double>(s) / result.substeps));
+            }
+            evaluate();
+            if (minute % recordEvery != 0 && minute % 60 != 0) continue;
+            computeLinePack();
+            if (minute % recordEvery == 0) writeRecord(out, minute);
+            if (minute % 60 == 0) result.hourly.push_back(snapshot(minute));
+        }
+        return result;
+    }
+};
+
+// Иерархия сжатия (contraction hierarchy) по весам труб. Вершины сжимаются
+// в порядке важности, вместо сжатой вершины добавляются ребра-сокращения,
+// если через нее проходит единственный кратчайший путь между соседями.
+// Запрос - двунаправленный Дейкстра только по ребрам к более важным вершинам.
+// Сжатие идет раундами: независимое множество вершин с локально минимальным
+// приоритетом обрабатывается параллельно. Иерархия строится для версии графа,
+// трубы в ремонте (бесконечный вес) в нее не входят.
+class ContractionHierarchy {
+private:
+    // Ребро иерархии: исходная труба (arc >= 0) или сокращение через middle
+    struct Shortcut {
+        int from;
+        int to;
+        double weight;
+        int arc;          // ребро графа from -> to (-1 для сокращения)
+        int reverseArc;   // ребро графа to -> from
+        int middle;       // сжатая вершина (-1 для исходного ребра)
+        int first;        // ребро from - middle
+        int second;       // ребро middle - to
+    };
+    
+    // Рабочие массивы поиска свидетелей одного потока
+    struct WitnessScratch {
+        vector<double> dist;
+        vector<int> stamp;
+        vector<int> targetStamp;  // отметка соседей v, до которых ищется свидетель
+        int current = 0;
+        vector<pair<double, int>> heap;
+    };
+    
+    // Ограничение числа вершин в поиске свидетелей: при оценке приоритета
+    // достаточно грубого ответа, при сжатии лишние сокращения замедляют запросы
+    static const int PRIORITY_SETTLE_LIMIT = 5;
+    static const int CONTRACTION_SETTLE_LIMIT = 100;
+    
+    vector<Shortcut> edges;
+    vector<int> rankNode;      // порядок сжатия -> вершина графа
+    vector<int> nodeRank;      // вершина графа -> порядок сжатия
+    // Ребра к более важным вершинам в формате CSR, вершины пронумерованы по порядку сжатия
+    vector<int> upBegin;
+    vector<int> upHead;
+    vector<double> upWeight;
+    vector<int> upEdge;
+    long long version = -1;
+    
+    static int otherEnd(const Shortcut& e, int v) {
+        return e.from == v ? e.to : e.from;
+    }
+    
+    // Сокращения, нужные при сжатии v: пары соседей (u, w), для которых
+    // в графе без v нет пути не длиннее u - v - w
+    void simulate(int v, const vector<vector<int>>& adjacency, const vector<bool>& contracted,
+                  WitnessScratch& scratch, vector<array<int, 2>>& needed, int settleLimit) const {
+        needed.clear();
+        const vector<int>& around = adjacency[v];
+        for (size_t i = 0; i + 1 < around.size(); ++i) {
+            int u = otherEnd(edges[around[i]], v);
+            double toU = edges[around[i]].weight;
+            double limit = 0;
+            for (size_t j = i + 1; j < around.size(); ++j) {
+                limit = max(limit, toU + edges[around[j]].weight);
+            }
+            
+            // Поиск свидетелей от u в графе без v с ограничением по длине и числу вершин
+            if (++scratch.current == numeric_limits<int>::max()) {
+                fill(scratch.stamp.begin(), scratch.stamp.end(), 0);
+                fill(scratch.targetStamp.begin(), scratch.targetStamp.end(), 0);
+                scratch.current = 1;
+            }
+            int targetsLeft = around.size() - i - 1;
+            for (size_t j = i + 1; j < around.size(); ++j) {
+                scratch.targetStamp[otherEnd(edges[around[j]], v)] = scratch.current;
+            }
+            auto distOf = [&](int x) {
+                return scratch.stamp[x] == scratch.current ? scratch.dist[x] : ShortestPathSolver::INF;
+            };
+            auto& heap = scratch.heap;
+            heap.clear();
+            scratch.stamp[u] = scratch.current;
+            scratch.dist[u] = 0;
+            heap.push_back({0, u});
+            int settled = 0;
+            while (!heap.empty() && settled < settleLimit && targetsLeft > 0) {
+                pop_heap(heap.begin(), heap.end(), greater<pair<double, int>>());
+                auto [d, x] = heap.back();
+                heap.pop_back();
+                if (d > distOf(x)) continue;
+                if (d > limit) break;
+                settled++;
+                if (scratch.targetStamp[x] == scratch.current) targetsLeft--;
+                for (int e : adjacency[x]) {
+                    int y = otherEnd(edges[e], x);
+                    if (y == v || contracted[y]) continue;
+                    double nd = d + edges[e].weight;
+                    if (nd < distOf(y)) {
+                        scratch.stamp[y] = scratch.current;
+                        scratch.dist[y] = nd;
+                        heap.push_back({nd, y});
+                        push_heap(heap.begin(), heap.end(), greater<pair<double, int>>());
+                    }
+                }
+            }
+            
+            for (size_t j = i + 1; j < around.size(); ++j) {
+                int w = otherEnd(edges[around[j]], v);
+                if (distOf(w) > toU + edges[around[j]].weight) {
+                    needed.push_back({around[i], around[j]});
+                }
+            }
+        }
+    }
+    
+    // Запись ребра (или сокращения) между u и w: оставляем только самое короткое
+    void link(vector<vector<int>>& adjacency, int u, int w, int edge) {
+        for (int& e : adjacency[u]) {
+            if (otherEnd(edges[e], u) == w) {
+                if (edges[edge].weight < edges[e].weight) e = edge;
+                return;
+            }
+        }
+        adjacency[u].push_back(edge);
+    }
+    
+    // Раскрытие сокращения в ребра графа в направлении от вершины from
+    void unpack(int edge, int from, ShortestPathResult& path) const {
+        vector<pair<int, int>> stack = {{edge, from}};
+        while (!stack.empty()) {
+            auto [e, v] = stack.back();
+            stack.pop_back();
+            const Shortcut& s = edges[e];
+            if (s.middle == -1) {
+                path.arcs.push_back(s.from == v ? s.arc : s.reverseArc);
+                path.nodes.push_back(otherEnd(s, v));
+            } else if (s.from == v) {
+                stack.push_back({s.second, s.middle});
+                stack.push_back({s.first, v});
+            } else {
+                stack.push_back({s.first, s.middle});
+                stack.push_back({s.second, v});
+            }
+        }
+    }
+
+public:
+    void build(const NetworkGraph& g) {
+        int n = g.nodeCount();
+        edges.clear();
+        rankNode.clear();
+        nodeRank.assign(n, -1);
+        vector<vector<int>> adjacency(n);
+        
+        // Исходные ребра: по одному на пару вершин, минимального веса
+        for (int u = 0; u < n; ++u) {
+            for (int a = g.arcsBegin(u); a < g.arcsEnd(u); ++a) {
+                const GraphEdge& arc = g.arc(a);
+                if (!arc.forward || arc.to == u || arc.weight == ShortestPathSolver::INF) continue;
+                edges.push_back({u, arc.to, arc.weight, a, arc.rev, -1, -1, -1});
+                link(adjacency, u, arc.to, edges.size() - 1);
+                link(adjacency, arc.to, u, edges.size() - 1);
+            }
+        }
+        
+        // Приоритет вершины: разность сокращений и ребер, число сжатых соседей
+        // и уровень (глубина в иерархии) - для равномерного сжатия по сети
+        vector<bool> contracted(n, false);
+        vector<int> contractedNeighbours(n, 0);
+        vector<int> level(n, 0);
+        vector<int> priority(n, 0);
+        vector<vector<array<int, 2>>> pending(n);
+        vector<WitnessScratch> scratch(parallelWorkers());
+        for (auto& s : scratch) {
+            s.dist.assign(n, ShortestPathSolver::INF);
+            s.stamp.assign(n, 0);
+            s.targetStamp.assign(n, 0);
+        }
+        auto evaluate = [&](const vector<int>& nodes) {
+            parallelFor(nodes.size(), [&](int worker, int i) {
+                int v = nodes[i];
+                simulate(v, adjacency, contracted, scratch[worker], pending[v], PRIORITY_SETTLE_LIMIT);
+                int difference = static_cast<int>(pending[v].size()) - static_cast<int>(adjacency[v].size());
+                priority[v] = 2 * difference + contractedNeighbours[v] + level[v];
+            });
+        };
+        
+        vector<int> remaining(n);
+        for (int v = 0; v < n; ++v) remaining[v] = v;
+        evaluate(remaining);
+        
+        vector<bool> dirty(n, false);
+        while (!remaining.empty()) {
+            // Независимое множество: приоритет меньше, чем у всех несжатых соседей
+            vector<int> batch;
+            for (int v : remaining) {
+                bool minimal = true;
+                for (int e : adjacency[v]) {
+                    int u = otherEnd(edges[e], v);
+                    if (make_pair(priority[u], u) < make_pair(priority[v], v)) {
+                        minimal = false;
+                        break;
+                    }
+                }
+                if (minimal) batch.push_back(v);
+            }
+            
+            // Сокращения ищутся без всех вершин раунда: иначе две вершины
+            // могут служить свидетелями друг для друга, и нужное сокращение пропадет
+            for (int v : batch) contracted[v] = true;
+            parallelFor(batch.size(), [&](int worker, int i) {
+                simulate(batch[i], adjacency, contracted, scratch[worker], pending[batch[i]],
+                         CONTRACTION_SETTLE_LIMIT);
+            });
+            
+            vector<int> touched;
+            for (int v : batch) {
+                nodeRank[v] = rankNode.size();
+                rankNode.push_back(v);
+                for (const auto& via : pending[v]) {
+                    int u = otherEnd(edges[via[0]], v);
+                    int w = otherEnd(edges[via[1]], v);
+                    double weight = edges[via[0]].weight + edges[via[1]].weight;
+                    edges.push_back({u, w, weight, -1, -1, v, via[0], via[1]});
+                    link(adjacency, u, w, edges.size() - 1);
+                    link(adjacency, w, u, edges.size() - 1);
+                }
+                pending[v].clear();
+            }
+            // У соседей убираем ребра к сжатым вершинам, в adjacency[v] остаются ребра вверх
+            for (int v : batch) {
+                for (int e : adjacency[v]) {
+                    int u = otherEnd(edges[e], v);
+                    auto& list = adjacency[u];
+                    list.erase(remove(list.begin(), list.end(), e), list.end());
+                    contractedNeighbours[u]++;
+                    level[u] = max(level[u], level[v] + 1);
+                    if (!dirty[u]) {
+                        dirty[u] = true;
+                        touched.push_back(u);
+                    }
+                }
+            }
+            
+            remaining.erase(remove_if(remaining.begin(), remaining.end(),
+                                      [&](int v) { return contracted[v]; }), remaining.end());
+            for (int u : touched) dirty[u] = false;
+            evaluate(touched);
+        }
+        
+        // Ребра вверх, вершины в порядке сжатия: поиск идет по соседним участкам памяти
+        upBegin.assign(n + 1, 0);
+        upHead.clear();
+        upWeight.clear();
+        upEdge.clear();
+        for (int r = 0; r < n; ++r) {
+            int v = rankNode[r];
+            upBegin[r] = upHead.size();
+            for (int e : adjacency[v]) {
+                upHead.push_back(nodeRank[otherEnd(edges[e], v)]);
+                upWeight.push_back(edges[e].weight);
+                upEdge.push_back(e);
+            }
+        }
+        upBegin[n] = upHead.size();
+        version = g.getVersion();
+    }
+    
+    long long getVersion() const { return version; }
+    int shortcutCount() const {
+        return count_if(edges.begin(), edges.end(), [](const Shortcut& e) { return e.middle != -1; });
+    }
+    
+    // Двунаправленный поиск вверх по иерархии с раскрытием сокращений.
+    // Состояние поиска - в рабочих областях потока (вершины - по порядку сжатия),
+    // поэтому запросы к одной иерархии можно выполнять параллельно
+    ShortestPathResult query(int source, int target) const {
+        ShortestPathResult result;
+        int n = rankNode.size();
+        SearchWorkspace* ws[2] = {&SearchWorkspace::local(0), &SearchWorkspace::local(1)};
+        int ends[2] = {nodeRank[source], nodeRank[target]};
+        for (int side = 0; side < 2; ++side) {
+            ws[side]->reset(n);
+            ws[side]->reach(ends[side], 0, -1);
+            ws[side]->heap.update(ends[side], 0);
+        }
+        
+        double best = ShortestPathSolver::INF;
+        int meeting = -1;
+        while (true) {
+            // Дальнейший поиск со стороны, где минимум очереди не меньше best, не улучшит ответ
+            for (SearchWorkspace* sideWs : ws) {
+                if (!sideWs->heap.empty() && sideWs->heap.topKey() >= best) sideWs->heap.reset(n);
+            }
+            if (ws[0]->heap.empty() && ws[1]->heap.empty()) break;
+            int side = ws[1]->heap.empty() ||
+                       (!ws[0]->heap.empty() && ws[0]->heap.topKey() <= ws[1]->heap.topKey()) ? 0 : 1;
+            SearchWorkspace& own = *ws[side];
+            int u = own.heap.pop();
+            if (own.settled(u)) continue;
+            own.settle(u);
+            double d = own.dist(u);
+            result.settled++;
+            
+            double other = ws[1 - side]->dist(u);
+            if (d + other < best) {
+                best = d + other;
+                meeting = u;
+            }
+            
+            // Остановка по требованию: если к u короче прийти сверху,
+            // найденное расстояние не кратчайшее и продолжать из u бессмысленно
+            bool stalled = false;
+            for (int i = upBegin[u]; i < upBegin[u + 1]; ++i) {
+                if (own.dist(upHead[i]) + upWeight[i] < d) {
+                    stalled = true;
+                    break;
+                }
+            }
+            if (stalled) continue;
+            
+            for (int i = upBegin[u]; i < upBegin[u + 1]; ++i) {
+                int v = upHead[i];
+                double nd = d + upWeight[i];
+                if (nd < own.dist(v)) {
+                    own.reach(v, nd, i);
+                    own.heap.update(v, nd);
+                }
+            }
+        }
+        
+        if (meeting == -1) return result;
+        result.distance = best;
+        
+        // Ребра иерархии от начала до точки встречи и от нее до конца
+        auto parentOf = [&](int side, int v) {
+            const Shortcut& e = edges[upEdge[ws[side]->parent(v)]];
+            return nodeRank[otherEnd(e, rankNode[v])];
+        };
+        vector<pair<int, int>> chain;
+        for (int v = meeting; v != ends[0]; ) {
+            int u = parentOf(0, v);
+            chain.push_back({upEdge[ws[0]->parent(v)], rankNode[u]});
+            v = u;
+        }
+        reverse(chain.begin(), chain.end());
+        for (int v = meeting; v != ends[1]; ) {
+            int u = parentOf(1, v);
+            chain.push_back({upEdge[ws[1]->parent(v)], rankNode[v]});
+            v = u;
+        }
+        
+        result.nodes.push_back(source);
+        for (const auto& [e, from] : chain) {
+            unpack(e, from, result);
+        }
+        return result;
+    }
+};
+
+// Настраиваемая иерархия сжатия (CCH). Порядок сжатия зависит только от
+// топологии сети (вложенные сечения), веса задаются отдельной настройкой.
+// Трубы в ремонте остаются в топологии с бесконечным весом, поэтому смена
+// статуса ремонта или длины трубы пересчитывает только зависящие от нее сокращения.
+class CustomizableHierarchy {
+private:
+    // Вершины пронумерованы по порядку сжатия; ребра вверх - CSR, головы по возрастанию
+    vector<int> rankNode;
+    vector<int> nodeRank;
+    vector<int> upBegin;
+    vector<int> upHead;
+    vector<int> upTail;          // младший конец ребра
+    vector<double> weight;       // вес после настройки
+    vector<double> inputWeight;  // вес исходных труб между концами ребра (INF, если труб нет)
+    vector<int> inputArc;        // ребро графа от младшей вершины к старшей (-1, если труб нет)
+    vector<int> inputReverseArc;
+    vector<int> lowerFirst;      // ребро (x, u) нижнего треугольника, давшего вес ребру (u, w)
+    vector<int> lowerSecond;     // ребро (x, w) того же треугольника (-1 - вес исходной трубы)
+    vector<int> downBegin;       // ребра (x, u) с младшим концом x - по вершине u
+    vector<int> downEdge;
+    vector<int> downTail;
+    vector<int> parent;          // родитель в дереве исключения (младшая из старших соседей)
+    vector<vector<int>> levels;  // вершины по уровням: нижние треугольники - только с меньших уровней
+    vector<char> updateState;    // частичная настройка: 1 - ребро затронуто, 2 - пересчитать целиком
+    vector<double> updatePrevious;
+    long long version = -1;
+    
+    // Порядок вложенных сечений: разделитель (слой обхода в ширину посередине
+    // компоненты) получает старшие номера, части упорядочиваются так же рекурсивно
+    void orderByNestedDissection(const NetworkGraph& g) {
+        int n = g.nodeCount();
+        const size_t SMALL_PART = 8;
+        vector<int> part(n, 0);    // номер части вершины (-1 - вершина уже упорядочена)
+        vector<int> depth(n, -1);
+        vector<int> reversedOrder; // вершины от старших к младшим
+        int nextPart = 1;
+        
+        // Обход в ширину внутри части; глубины остаются в depth до clearDepth
+        auto bfs = [&](int start, int id, vector<int>& visited) {
+            visited.assign(1, start);
+            depth[start] = 0;
+            for (size_t i = 0; i < visited.size(); ++i) {
+                int u = visited[i];
+                for (int a = g.arcsBegin(u); a < g.arcsEnd(u); ++a) {
+                    int v = g.arc(a).to;
+                    if (part[v] == id && depth[v] == -1) {
+                        depth[v] = depth[u] + 1;
+                        visited.push_back(v);
+                    }
+                }
+            }
+        };
+        auto clearDepth = [&](const vector<int>& visited) {
+            for (int v : visited) depth[v] = -1;
+        };
+        // Компоненты связности вершин части id становятся новыми частями
+        vector<vector<int>> stack;
+        auto splitComponents = [&](const vector<int>& nodes, int id) {
+            for (int v : nodes) {
+                if (part[v] != id) continue;
+                vector<int> component;
+                bfs(v, id, component);
+                clearDepth(component);
+                int childId = nextPart++;
+                for (int x : component) part[x] = childId;
+                stack.push_back(move(component));
+            }
+        };
+        
+        vector<int> all(n);
+        for (int v = 0; v < n; ++v) all[v] = v;
+        splitComponents(all, 0);
+        
+        vector<int> visited;
+        while (!stack.empty()) {
+            vector<int> nodes = move(stack.back());
+            stack.pop_back();
+            int id = part[nodes[0]];
+            if (nodes.size() <= SMALL_PART) {
+                for (int v : nodes) {
+                    reversedOrder.push_back(v);
+                    part[v] = -1;
+                }
+                continue;
+            }
+            
+            // Обход от почти периферийной вершины (самой дальней от произвольной)
+            bfs(nodes[0], id, visited);
+            int far = visited.back();
+            clearDepth(visited);
+            bfs(far, id, visited);
+            
+            // Разделитель - самый узкий слой среди тех, что оставляют
+            // по обе стороны не меньше трети части
+            int layers = depth[visited.back()] + 1;
+            vector<int> layerSize(layers, 0);
+            for (int v : visited) layerSize[depth[v]]++;
+            int middle = depth[visited[visited.size() / 2]];
+            int before = 0;
+            for (int d = 0; d < layers; ++d) {
+                int size = visited.size();
+                if (before >= size / 3 && before + layerSize[d] <= size - size / 3 &&
+                    layerSize[d] < layerSize[middle]) {
+                    middle = d;
+                }
+                before += layerSize[d];
+            }
+            // Вершины слоя без соседей в следующем слое ничего не разделяют
+            vector<int> separator;
+            for (int v : visited) {
+                if (depth[v] != middle) continue;
+                for (int a = g.arcsBegin(v); a < g.arcsEnd(v); ++a) {
+                    int w = g.arc(a).to;
+                    if (part[w] == id && depth[w] == middle + 1) {
+                        separator.push_back(v);
+                        break;
+                    }
+                }
+            }
+            if (separator.empty()) {
+                for (int v : visited) {
+                    if (depth[v] == middle) separator.push_back(v);
+                }
+            }
+            for (int v : separator) {
+                reversedOrder.push_back(v);
+                part[v] = -1;
+            }
+            clearDepth(visited);
+            splitComponents(visited, id);
+        }
+        rankNode.assign(reversedOrder.rbegin(), reversedOrder.rend());
+    }
+    
+    // Ребра вверх хордального надграфа для порядка rankNode (символьное исключение):
+    // соседи вершины вверх, кроме младшего, становятся соседями младшего
+    vector<vector<int>> eliminate(const NetworkGraph& g) {
+        int n = g.nodeCount();
+        vector<vector<int>> upper(n);
+        for (int r = 0; r < n; ++r) {
+            int v = rankNode[r];
+            for (int a = g.arcsBegin(v); a < g.arcsEnd(v); ++a) {
+                int w = nodeRank[g.arc(a).to];
+                if (w > r) upper[r].push_back(w);
+            }
+        }
+        for (int r = 0; r < n; ++r) {
+            vector<int>& heads = upper[r];
+            sort(heads.begin(), heads.end());
+            heads.erase(unique(heads.begin(), heads.end()), heads.end());
+            if (heads.size() > 1) {
+                vector<int>& parentHeads = upper[heads[0]];
+                parentHeads.insert(parentHeads.end(), heads.begin() + 1, heads.end());
+            }
+        }
+        return upper;
+    }
+    
+    // Вес ребра (u, w) по трубам между ними: минимальный, с запоминанием ребра графа
+    void loadInput(const NetworkGraph& g, int i, int lower) {
+        int u = rankNode[lower];
+        int w = rankNode[upHead[i]];
+        inputWeight[i] = ShortestPathSolver::INF;
+        inputArc[i] = -1;
+        inputReverseArc[i] = -1;
+        for (int a = g.arcsBegin(u); a < g.arcsEnd(u); ++a) {
+            if (g.arc(a).to == w && (inputArc[i] == -1 || g.arc(a).weight < inputWeight[i])) {
+                inputWeight[i] = g.arc(a).weight;
+                inputArc[i] = a;
+                inputReverseArc[i] = g.arc(a).rev;
+            }
+        }
+    }
+    
+    // Настройка ребер вверх вершины u по нижним треугольникам (x, u, w), x < u < w.
+    // Ребра младших вершин уже настроены.
+    void customizeNode(int u, vector<int>& position) {
+        for (int i = upBegin[u]; i < upBegin[u + 1]; ++i) position[upHead[i]] = i;
+        
+        for (int i = upBegin[u]; i < upBegin[u + 1]; ++i) {
+            weight[i] = inputWeight[i];
+            lowerFirst[i] = -1;
+            lowerSecond[i] = -1;
+        }
+        for (int j = downBegin[u]; j < downBegin[u + 1]; ++j) {
+            int first = downEdge[j];
+            int x = downTail[j];
+            if (weight[first] == ShortestPathSolver::INF) continue;
+            // Старшие соседи x после u - тоже соседи u (граф хордальный)
+            for (int second = first + 1; second < upBegin[x + 1]; ++second) {
+                int i = position[upHead[second]];
+                double candidate = weight[first] + weight[second];
+                if (candidate < weight[i]) {
+                    weight[i] = candidate;
+                    lowerFirst[i] = first;
+                    lowerSecond[i] = second;
+                }
+            }
+        }
+        
+        for (int i = upBegin[u]; i < upBegin[u + 1]; ++i) {
+            position[upHead[i]] = -1;
+        }
+    }
+    
+    // Пересчет одного ребра (u, w): общие младшие соседи u и w - слиянием
+    // списков ребер вниз (они упорядочены по младшему концу)
+    void recomputeEdge(int i) {
+        weight[i] = inputWeight[i];
+        lowerFirst[i] = -1;
+        lowerSecond[i] = -1;
+        int j = downBegin[upTail[i]];
+        int k = downBegin[upHead[i]];
+        int jEnd = downBegin[upTail[i] + 1];
+        int kEnd = downBegin[upHead[i] + 1];
+        while (j < jEnd && k < kEnd) {
+            if (downTail[j] < downTail[k]) {
+                ++j;
+            } else if (downTail[k] < downTail[j]) {
+                ++k;
+            } else {
+                double candidate = weight[downEdge[j]] + weight[downEdge[k]];
+                if (candidate < weight[i]) {
+                    weight[i] = candidate;
+                    lowerFirst[i] = downEdge[j];
+                    lowerSecond[i] = downEdge[k];
+                }
+                ++j;
+                ++k;
+            }
+        }
+    }
+    
+    // Раскрытие ребра иерархии в ребра графа; forward - от младшей вершины к старшей
+    void unpack(int edge, bool forward, ShortestPathResult& path) const {
+        vector<pair<int, bool>> stack = {{edge, forward}};
+        while (!stack.empty()) {
+            auto [i, up] = stack.back();
+            stack.pop_back();
+            if (lowerFirst[i] == -1) {
+                path.arcs.push_back(up ? inputArc[i] : inputReverseArc[i]);
+                path.nodes.push_back(rankNode[up ? upHead[i] : upTail[i]]);
+            } else if (up) {
+                // (u, w) = (u, x) + (x, w), x - младшая вершина треугольника
+                stack.push_back({lowerSecond[i], true});
+                stack.push_back({lowerFirst[i], false});
+            } else {
+                stack.push_back({lowerFirst[i], true});
+                stack.push_back({lowerSecond[i], false});
+            }
+        }
+    }
+
+public:
+    // Полная подготовка: порядок, структура ребер и настройка по текущим весам
+    void build(const NetworkGraph& g) {
+        int n = g.nodeCount();
+        orderByNestedDissection(g);
+        nodeRank.assign(n, -1);
+        for (int r = 0; r < n; ++r) nodeRank[rankNode[r]] = r;
+        vector<vector<int>> upper = eliminate(g);
+        
+        upBegin.assign(n + 1, 0);
+        upHead.clear();
+        upTail.clear();
+        for (int r = 0; r < n; ++r) {
+            upBegin[r] = upHead.size();
+            upHead.insert(upHead.end(), upper[r].begin(), upper[r].end());
+            upTail.insert(upTail.end(), upper[r].size(), r);
+        }
+        upBegin[n] = upHead.size();
+        int m = upHead.size();
+        
+        // Обратные ссылки: ребра (x, u) по старшей вершине u
+        downBegin.assign(n + 1, 0);
+        for (int i = 0; i < m; ++i) downBegin[upHead[i] + 1]++;
+        for (int r = 0; r < n; ++r) downBegin[r + 1] += downBegin[r];
+        downEdge.assign(m, -1);
+        downTail.assign(m, -1);
+        vector<int> fill(downBegin.begin(), downBegin.end() - 1);
+        for (int x = 0; x < n; ++x) {
+            for (int i = upBegin[x]; i < upBegin[x + 1]; ++i) {
+                downEdge[fill[upHead[i]]] = i;
+                downTail[fill[upHead[i]]++] = x;
+            }
+        }
+        
+        parent.assign(n, -1);
+        vector<int> level(n, 0);
+        levels.clear();
+        for (int r = 0; r < n; ++r) {
+            if (upBegin[r] < upBegin[r + 1]) parent[r] = upHead[upBegin[r]];
+            for (int j = downBegin[r]; j < downBegin[r + 1]; ++j) {
+                level[r] = max(level[r], level[downTail[j]] + 1);
+            }
+            if (level[r] >= static_cast<int>(levels.size())) levels.resize(level[r] + 1);
+            levels[level[r]].push_back(r);
+        }
+        
+        weight.assign(m, ShortestPathSolver::INF);
+        inputWeight.assign(m, ShortestPathSolver::INF);
+        inputArc.assign(m, -1);
+        inputReverseArc.assign(m, -1);
+        lowerFirst.assign(m, -1);
+        lowerSecond.assign(m, -1);
+        updateState.assign(m, 0);
+        updatePrevious.assign(m, 0.0);
+        for (int r = 0; r < n; ++r) {
+            for (int i = upBegin[r]; i < upBegin[r + 1]; ++i) loadInput(g, i, r);
+        }
+        customize();
+        version = g.getVersion();
+    }
+    
+    // Настройка всех весов: вершины одного уровня независимы и обрабатываются параллельно
+    void customize() {
+        int n = rankNode.size();
+        vector<vector<int>> position(parallelWorkers(), vector<int>(n, -1));
+        for (const auto& nodes : levels) {
+            parallelFor(nodes.size(), [&](int worker, int i) {
+                customizeNode(nodes[i], position[worker]);
+            });
+        }
+    }
+    
+    // Изменился вес трубы (ремонт, длина): пересчет только зависящих ребер.
+    // Граф уже исправлен на месте, структура ребер прежняя.
+    void updateArc(const NetworkGraph& g, int arc) {
+        if (arc == -1) {
+            version = g.getVersion();
+            return;
+        }
+        int u = nodeRank[g.tail(arc)];
+        int w = nodeRank[g.arc(arc).to];
+        if (u > w) swap(u, w);
+        int i = lower_bound(upHead.begin() + upBegin[u], upHead.begin() + upBegin[u + 1], w) - upHead.begin();
+        loadInput(g, i, u);
+        
+        // Измененное ребро (x, h) входит в нижние треугольники (x, h, y) ребер между h и y.
+        // Уменьшение через треугольник применяется сразу; если подорожал треугольник,
+        // дававший минимум, ребро пересчитывается целиком. Ребра обрабатываются по
+        // возрастанию младшего конца (так упорядочены номера в CSR), поэтому к моменту
+        // пересчета все слагаемые уже окончательные.
+        vector<int> touched;
+        auto touch = [&](int e, bool recompute) {
+            if (updateState[e] == 0) {
+                updatePrevious[e] = weight[e];
+                touched.push_back(e);
+            }
+            if (recompute) updateState[e] = 2;
+            else if (updateState[e] == 0) updateState[e] = 1;
+        };
+        priority_queue<int, vector<int>, greater<int>> dirty;
+        touch(i, true);
+        dirty.push(i);
+        int last = -1;
+        while (!dirty.empty()) {
+            int e = dirty.top();
+            dirty.pop();
+            if (e == last) continue;
+            last = e;
+            if (updateState[e] == 2) recomputeEdge(e);
+            if (weight[e] == updatePrevious[e]) continue;
+            
+            int x = upTail[e];
+            for (int k = upBegin[x]; k < upBegin[x + 1]; ++k) {
+                if (k == e) continue;
+                int low = upHead[k] < upHead[e] ? k : e;    // ребро (x, младший конец f)
+                int high = low == k ? e : k;                // ребро (x, старший конец f)
+                int f = lower_bound(upHead.begin() + upBegin[upHead[low]], upHead.begin() + upBegin[upHead[low] + 1],
+                                    upHead[high]) - upHead.begin();
+                double candidate = weight[e] + weight[k];
+                if (candidate < weight[f]) {
+                    touch(f, false);
+                    weight[f] = candidate;
+                    lowerFirst[f] = low;
+                    lowerSecond[f] = high;
+                    dirty.push(f);
+                } else if (lowerFirst[f] == low && candidate > weight[f]) {
+                    touch(f, true);
+                    dirty.push(f);
+                }
+            }
+        }
+        for (int e : touched) updateState[e] = 0;
+        version = g.getVersion();
+    }
+    
+    long long getVersion() const { return version; }
+    int edgeCount() const { return upHead.size(); }
+    
+    // Запрос: подъем по дереву исключения от обеих вершин без очереди с приоритетами.
+    // Расстояния - в рабочих областях потока, запросы можно выполнять параллельно
+    ShortestPathResult query(int source, int target) const {
+        ShortestPathResult result;
+        SearchWorkspace* ws[2] = {&SearchWorkspace::local(0), &SearchWorkspace::local(1)};
+        int ends[2] = {nodeRank[source], nodeRank[target]};
+        for (int side = 0; side < 2; ++side) {
+            SearchWorkspace& own = *ws[side];
+            own.reset(rankNode.size());
+            own.reach(ends[side], 0, -1);
+            for (int v = ends[side]; v != -1; v = parent[v]) {
+                result.settled++;
+                double d = own.dist(v);
+                if (d == ShortestPathSolver::INF) continue;
+                for (int i = upBegin[v]; i < upBegin[v + 1]; ++i) {
+                    if (d + weight[i] < own.dist(upHead[i])) {
+                        own.reach(upHead[i], d + weight[i], i);
+                    }
+                }
+            }
+        }
+        
+        // Точка встречи - общий предок с минимальной суммой расстояний
+        double best = ShortestPathSolver::INF;
+        int meeting = -1;
+        for (int v = ends[0]; v != -1; v = parent[v]) {
+            if (ws[0]->dist(v) + ws[1]->dist(v) < best) {
+                best = ws[0]->dist(v) + ws[1]->dist(v);
+                meeting = v;
+            }
+        }
+        
+        if (meeting != -1) {
+            result.distance = best;
+            vector<int> chain;  // ребра от начала до точки встречи
+            for (int v = meeting; v != ends[0]; v = upTail[ws[0]->parent(v)]) {
+                chain.push_back(ws[0]->parent(v));
+            }
+            reverse(chain.begin(), chain.end());
+            result.nodes.push_back(source);
+            for (int i : chain) unpack(i, true, result);
+            for (int v = meeting; v != ends[1]; v = upTail[ws[1]->parent(v)]) {
+                unpack(ws[1]->parent(v), false, result);
+            }
+        }
+        return result;
+    }
+};
+
+class Logger {
+private:
+    mutable ofstream logFile;
+    
+public:
+    Logger() {
+        logFile.open("pipeline_log.txt", ios::app);
+        if (logFile.is_open()) {
+            auto now = chrono::system_clock::now();
+            auto time = chrono::system_clock::to_time_t(now);
+            logFile << "\n=== Сессия начата: " << ctime(&time);
+        }
+    }
+    
+    ~Logger() {
+        if (logFile.is_open()) {
+            auto now = chrono::system_clock::now();
+            auto time = chrono::system_clock::to_time_t(now);
+            logFile << "=== Сессия завершена: " << ctime(&time) << endl;
+            logFile.close();
+        }
+    }
+    
+    void log(const string& action, const string& details = "") const {
+        if (logFile.is_open()) {
+            auto now = chrono::system_clock::now();
+            auto time = chrono::system_clock::to_time_t(now);
+            
+            char timeStr[20];
+            strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", localtime(&time));
+            
+            logFile << timeStr << " | " << action;
+            if (!details.empty()) {
+                logFile << " | " << details;
+            }
+            logFile << endl;
+        }
+    }
+};
+
+class InputValidator {
+public:
+    static int getIntInput(const string& prompt, int min = numeric_limits<int>::min(),
+                          int max = numeric_limits<int>::max()) {
+        int value;
+        while (true) {
+            cout << prompt;
+            string input;
+            getline(cin, input);
+            
+            if (input.empty()) {
+                cout << "Ошибка: ввод не может быть пустым.\n";
+                continue;
+            }
+            
+            try {
+                value = stoi(input);
+                if (value < min || value > max) {
+                    cout << "Ошибка: значение должно быть от " << min << " до " << max << ".\n";
+                    continue;
+                }
+                break;
+            } catch (const exception&) {
+                cout << "Ошибка: пожалуйста, введите целое число.\n";
+            }
+        }
+        return value;
+    }
+
+    static double getDoubleInput(const string& prompt, double min = 0.0,
+                               double max = numeric_limits<double>::max()) {
+        double value;
+        while (true) {
+            cout << prompt;
+            string input;
+            getline(cin, input);
+            
+            if (input.empty()) {
+                cout << "Ошибка: ввод не может быть пустым.\n";
+                continue;
+            }
+            
+            try {
+                value = stod(input);
+                if (value < min || value > max) {
+                    cout << "Ошибка: значение должно быть от " << min << " до " << max << ".\n";
+                    continue;
+                }
+                break;
+            } catch (const exception&) {
+                cout << "Ошибка: пожалуйста, введите число.\n";
+            }
+        }
+        return value;
+    }
+
+    static string getStringInput(const string& prompt) {
+        string input;
+        while (true) {
+            cout << prompt;
+            getline(cin, input);
+            if (!input.empty()) {
+                break;
+            }
+            cout << "Ошибка: ввод не может быть пустым.\n";
+        }
+        return input;
+    }
+
+    static int getDiameterInput(const string& prompt) {
+        while (true) {
+            cout << prompt << " (500, 700, 1000, 1400 мм): ";
+            string input;
+            getline(cin, input);
+            
+            if (input.empty()) {
+                cout << "Ошибка: ввод не может быть пустым.\n";
+                continue;
+            }
+            
+            try {
+                int diameter = stoi(input);
+                for (const auto& cap : PIPE_CAPACITIES) {
+                    if (cap.diameter == diameter) {
+                        return diameter;
+                    }
+                }
+                cout << "Ошибка: допустимые диаметры: 500, 700, 1000, 1400 мм\n";
+            } catch (const exception&) {
+                cout << "Ошибка: пожалуйста, введите целое число.\n";
+            }
+        }
+    }
+};
+
+class PipelineSystem {
+private:
+    vector<Pipe> pipes;
+    vector<CompressorStation> stations;
+    vector<NetworkConnection> network;
+    int nextPipeId = 1;
+    int nextStationId = 1;
+    Logger logger;
+    
+    // Индексы ID -> позиция в векторах pipes и stations
+    IdIndex pipeIdIndex;
+    IdIndex stationIdIndex;
+    
+    // Граф сети для алгоритмов и счетчик изменений сети
+    mutable NetworkGraph graph;
+    long long networkVersion = 0;
+    
+    // Ориентиры для A* (ALT)
+    static const int LANDMARK_COUNT = 8;
+    mutable LandmarkTable landmarks;
+    
+    // Иерархия сжатия для массовых запросов кратчайшего пути
+    mutable ContractionHierarchy contractionHierarchy;
+    
+    // Настраиваемая иерархия: при изменении веса трубы пересчитывается частично
+    mutable CustomizableHierarchy customizableHierarchy;
+    
+    // Максимальный остовный лес для запросов пути наибольшей пропускной способности
+    mutable WidestPathTree widestPathTree;
+    
+    // Дерево Гомори-Ху для запросов максимального потока между любыми КС
+    mutable GomoryHuTree gomoryHuTree;
+    
+    // Гидравлический расчет: хранит портрет разложения между расчетами
+    mutable HydraulicSolver hydraulicSolver;
+    
+    // Нестационарный расчет: массивы состояния труб и узлов между запусками
+    TransientSimulator transientSimulator;
+    
+    // Наибольшее число меток вершины при многокритериальном поиске маршрутов
+    static const int PARETO_LABEL_LIMIT = 16;
+    
+    // Деревья кратчайших путей от недавних источников (потенциалы для пар
+    // маршрутов без общих труб), сбрасываются при смене версии графа
+    static const int POTENTIAL_CACHE_SIZE = 16;
+    mutable map<int, ShortestPathTree> potentialCache;
+    mutable long long potentialCacheVersion = -1;
+    
+    // Граф с разделенными КС и счетчик изменений производительности КС
+    mutable NetworkGraph splitGraph;
+    mutable long long splitStationsVersion = -1;
+    long long stationsVersion = 0;
+
+    // Последний результат расчета потока для недавних пар (источник, сток, учет КС);
+    // результат хранит потоки по всем дугам, поэтому число пар ограничено
+    static const int MAX_FLOW_CACHE_SIZE = 8;
+    struct MaxFlowCacheEntry {
+        long long networkVersion;
+        long long stationsVersion;
+        MaxFlowResult result;
+    };
+    mutable map<tuple<int, int, bool>, MaxFlowCacheEntry> maxFlowCache;
+
+    // Полная смена данных сети (загрузка): графы перестроятся при следующем запросе
+    void markNetworkChanged() {
+        ++networkVersion;
+        maxFlowCache.clear();
+    }
+
+    // Точечное изменение сети: актуальные графы правятся на месте за O(степени),
+    // устаревшие перестроятся при следующем запросе. Версия растет в любом случае.
+    void applyNetworkDelta(const GraphDelta& delta) {
+        long long previous = networkVersion++;
+        if (graph.getVersion() == previous) {
+            if (!graph.applyDelta(delta, networkVersion)) {
+                graph.invalidate();
+            } else if (delta.type == ARC_UPDATED && customizableHierarchy.getVersion() == previous) {
+                customizableHierarchy.updateArc(graph, graph.forwardArc(delta.pipeId));
+            }
+        }
+        // Новый объект в графе с разделенными КС требует перестроения
+        if (splitGraph.getVersion() == previous && !splitGraph.applyDelta(delta, networkVersion)) {
+            splitGraph.invalidate();
+        }
+    }
+
+    // Изменение трубы, связанной с соединением
+    GraphDelta makePipeDelta(GraphDeltaType type, int pipeId, int startId = 0, int endId = 0) const {
+        const Pipe& pipe = pipes[findPipeIndexById(pipeId)];
+        return {type, pipeId, startId, endId, pipe.getCapacity(), pipe.getWeight()};
+    }
+
+    // Вызывается при изменении работающих цехов или класса КС
+    void markStationsChanged(int stationIndex) {
+        long long previous = stationsVersion++;
+        if (splitStationsVersion == previous && splitGraph.getVersion() == networkVersion) {
+            const CompressorStation& station = stations[stationIndex];
+            splitGraph.updateStationCapacity(station.id, station.getCapacity());
+            splitStationsVersion = stationsVersion;
+        }
+    }
+
+    // Граф сети, актуальный для текущей версии (перестраивается только при изменениях)
+    const NetworkGraph& getGraph() const {
+        if (graph.getVersion() != networkVersion) {
+            graph.build(network, pipes, pipeIdIndex, networkVersion);
+        }
+        return graph;
+    }
+
+    // Граф с ограничением производительности КС (кэшируется так же, как основной граф)
+    const NetworkGraph& getSplitGraph() const {
+        if (splitGraph.getVersion() != networkVersion || splitStationsVersion != stationsVersion) {
+            splitGraph.buildSplit(network, pipes, pipeIdIndex, stations, stationIdIndex, networkVersion);
+            splitStationsVersion = stationsVersion;
+        }
+        return splitGraph;
+    }
+
+    int findPipeIndexById(int id) const {
+        return pipeIdIndex.find(id);
+    }
+
+    int findStationIndexById(int id) const {
+        return stationIdIndex.find(id);
+    }
+
+    vector<int> parseIndicesFromInput(const string& input, const vector<int>& validIds) const {
+        if (input == "all" || input == "ALL") {
+            vector<int> allIndices;
+            for (int i = 0; i < validIds.size(); ++i) {
+                allIndices.push_back(i);
+            }
+            return allIndices;
+        }
+        
+        vector<int> indices;
+        stringstream ss(input);
+        string token;
+        
+        while (getline(ss, token, ',')) {
+            try {
+                int id = stoi(token);
+                auto it = find(validIds.begin(), validIds.end(), id);
+                if (it != validIds.end()) {
+                    indices.push_back(distance(validIds.begin(), it));
+                } else {
+                    cout << "Предупреждение: ID " << id << " не существует.\n";
+                }
+            } catch (const exception&) {
+                cout << "Предупреждение: '" << token << "' не является числом.\n";
+            }
+        }
+        
+        sort(indices.begin(), indices.end());
+        indices.erase(unique(indices.begin(), indices.end()), indices.end());
+        return indices;
+    }
+
+    vector<int> selectMultipleObjects(const vector<int>& validIds, const string& objectType) const {
+        if (validIds.empty()) {
+            cout << "Нет доступных " << objectType << "!\n";
+            return {};
+        }
+        
+        cout << "\nВыберите ID " << objectType << " через запятую или 'all' для всех: ";
+        string input;
+        getline(cin, input);
+        
+        return parseIndicesFromInput(input, validIds);
+    }
+
+    vector<int> getPipeIds() const {
+        vector<int> ids;
+        for (const auto& pipe : pipes) {
+            ids.push_back(pipe.id);
+        }
+        return ids;
+    }
+
+    vector<int> getStationIds() const {
+        vector<int> ids;
+        for (const auto& station : stations) {
+            ids.push_back(station.id);
+        }
+        return ids;
+    }
+
+    static string toLower(const string& str) {
+        string result = str;
+        transform(result.begin(), result.end(), result.begin(), ::tolower);
+        return result;
+    }
+
+    double calculateInactivePercent(const CompressorStation& station) const {
+        return station.totalWorkshops > 0 ?
+               100.0 * (station.totalWorkshops - station.activeWorkshops) / station.totalWorkshops : 0.0;
+    }
+
+    vector<int> findPipesByName(const string& searchName) const {
+        vector<int> result;
+        string searchLower = toLower(searchName);
+        
+        for (size_t i = 0; i < pipes.size(); ++i) {
+            if (toLower(pipes[i].name).find(searchLower) != string::npos) {
+                result.push_back(i);
+            }
+        }
+        return result;
+    }
+
+    vector<int> findPipesByRepairStatus(bool repairStatus) const {
+        vector<int> result;
+        for (size_t i = 0; i < pipes.size(); ++i) {
+            if (pipes[i].underRepair == repairStatus) {
+                result.push_back(i);
+            }
+        }
+        return result;
+    }
+
+    vector<int> findStationsByName(const string& searchName) const {
+        vector<int> result;
+        string searchLower = toLower(searchName);
+        
+        for (size_t i = 0; i < stations.size(); ++i) {
+            if (toLower(stations[i].name).find(searchLower) != string::npos) {
+                result.push_back(i);
+            }
+        }
+        return result;
+    }
+
+    vector<int> findStationsByInactivePercent(double targetPercent, int comparisonType) const {
+        vector<int> result;
+        for (size_t i = 0; i < stations.size(); ++i) {
+            double inactivePercent = calculateInactivePercent(stations[i]);
+            bool match = false;
+            
+            switch (comparisonType) {
+                case 1: match = (inactivePercent > targetPercent); break;
+                case 2: match = (inactivePercent < targetPercent); break;
+                case 3: match = (abs(inactivePercent - targetPercent) < 0.01); break;
+            }
+            
+            if (match) {
+                result.push_back(i);
+            }
+        }
+        return result;
+    }
+
+    void displayObjects(const vector<int>& pipeIndices, const vector<int>& stationIndices) const {
+        if (pipeIndices.empty() && stationIndices.empty()) {
+            cout << "Нет объектов для отображения.\n";
+            return;
+        }
+        
+        if (!pipeIndices.empty()) {
+            cout << "\nТрубы (" << pipeIndices.size() << ")\n";
+            cout << "ID | Название | Длина | Диаметр | В ремонте | В сети | Начало -> Конец | Произв.\n";
+            cout << string(90, '-') << endl;
+            for (int index : pipeIndices) {
+                const Pipe& pipe = pipes[index];
+                cout << setw(3) << pipe.id << " | "
+                     << setw(10) << left << (pipe.name.length() > 10 ? pipe.name.substr(0, 7) + "..." : pipe.name) << " | "
+                     << setw(6) << fixed << setprecision(2) << pipe.length << " | "
+                     << setw(7) << pipe.diameter << " | "
+                     << setw(10) << (pipe.underRepair ? "Да" : "Нет") << " | "
+                     << setw(6) << (pipe.inUse ? "Да" : "Нет") << " | ";
+                
+                if (pipe.inUse) {
+                    string startStr, endStr;
+                    
+                    if (pipe.startType == STATION_TO_STATION || pipe.startType == STATION_TO_PIPE) {
+                        startStr = "КС" + to_string(pipe.startId);
+                    } else {
+                        startStr = "Тр" + to_string(pipe.startId);
+                    }
+                    
+                    if (pipe.endType == STATION_TO_STATION || pipe.endType == PIPE_TO_STATION) {
+                        endStr = "КС" + to_string(pipe.endId);
+                    } else {
+                        endStr = "Тр" + to_string(pipe.endId);
+                    }
+                    
+                    cout << setw(5) << startStr << " -> " << setw(5) << endStr << " | ";
+                } else {
+                    cout << "Не подключена            | ";
+                }
+                
+                cout << setw(8) << fixed << setprecision(1) << pipe.getCapacity() << endl;
+            }
+        }
+
+        if (!stationIndices.empty()) {
+            cout << "\nКС (" << stationIndices.size() << ")\n";
+            cout << "ID | Название | Всего цехов | Работает | Незадействовано | Класс | Произв. | Баланс\n";
+            cout << string(90, '-') << endl;
+            for (int index : stationIndices) {
+                const CompressorStation& station = stations[index];
+                double inactivePercent = calculateInactivePercent(station);
+                cout << setw(3) << station.id << " | "
+                     << setw(10) << left << (station.name.length() > 10 ? station.name.substr(0, 7) + "..." : station.name) << " | "
+                     << setw(12) << station.totalWorkshops << " | "
+                     << setw(9) << station.activeWorkshops << " | "
+                     << setw(15) << fixed << setprecision(1) << inactivePercent << "% | "
+                     << setw(5) << station.stationClass << " | "
+                     << setw(8) << fixed << setprecision(1) << station.getCapacity() << " | "
+                     << setw(8) << station.balance << endl;
+            }
+        }
+    }
+
+    // Поиск свободной трубы по диаметру
+    int findAvailablePipeByDiameter(int diameter) const {
+        for (size_t i = 0; i < pipes.size(); ++i) {
+            if (pipes[i].diameter == diameter && !pipes[i].inUse && !pipes[i].underRepair) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    // Получение типа объекта по ID
+    pair<bool, int> getObjectInfo(int id) const {
+        // Проверяем, является ли ID станцией
+        int stationIndex = findStationIndexById(id);
+        if (stationIndex != -1) {
+            return {true, stationIndex}; // true = станция
+        }
+        
+        // Проверяем, является ли ID трубой
+        int pipeIndex = findPipeIndexById(id);
+        if (pipeIndex != -1) {
+            return {false, pipeIndex}; // false = труба
+        }
+        
+        return {false, -1}; // не найдено
+    }
+
+    // Определение типа соединения
+    ConnectionType determineConnectionType(bool isStartStation, bool isEndStation) {
+        if (isStartStation && isEndStation) return STATION_TO_STATION;
+        if (!isStartStation && !isEndStation) return PIPE_TO_PIPE;
+        if (isStartStation && !isEndStation) return STATION_TO_PIPE;
+        return PIPE_TO_STATION;
+    }
+
+    // Проверка возможности соединения
+    bool canConnectObjects(int startId, int endId, int diameter) {
+        if (startId == endId) {
+            cout << "Ошибка: нельзя соединить объект с самим собой!\n";
+            return false;
+        }
+        
+        // Получаем информацию об объектах
+        auto [isStartStation, startIndex] = getObjectInfo(startId);
+        auto [isEndStation, endIndex] = getObjectInfo(endId);
+        
+        if (startIndex == -1) {
+            cout << "Ошибка: объект с ID " << startId << " не существует!\n";
+            return false;
+        }
+        
+        if (endIndex == -1) {
+            cout << "Ошибка: объект с ID " << endId << " не существует!\n";
+            return false;
+        }
+        
+        // Проверка для труб
+        if (!isStartStation) {
+            const Pipe& startPipe = pipes[startIndex];
+            if (startPipe.underRepair) {
+                cout << "Ошибка: труба " << startId << " в ремонте!\n";
+                return false;
+            }
+        }
+        
+        if (!isEndStation) {
+            const Pipe& endPipe = pipes[endIndex];
+            if (endPipe.underRepair) {
+                cout << "Ошибка: труба " << endId << " в ремонте!\n";
+                return false;
+            }
+        }
+        
+        // Проверка на существующее соединение (в одну сторону)
+        for (const auto& conn : network) {
+            if (conn.startId == startId && conn.endId == endId) {
+                cout << "Ошибка: соединение между этими объектами уже существует!\n";
+                return false;
+            }
+        }
+        
+        // Проверка диаметра для соединения труб с трубами
+        if (!isStartStation && !isEndStation) {
+            const Pipe& startPipe = pipes[startIndex];
+            const Pipe& endPipe = pipes[endIndex];
+            
+            if (startPipe.diameter != diameter || endPipe.diameter != diameter) {
+                cout << "Ошибка: диаметр соединяющей трубы должен совпадать с диаметром соединяемых труб!\n";
+                cout << "Диаметр трубы " << startId << ": " << startPipe.diameter << " мм\n";
+                cout << "Диаметр трубы " << endId << ": " << endPipe.diameter << " мм\n";
+                cout << "Диаметр соединяющей трубы: " << diameter << " мм\n";
+                return false;
             }
         }
         
         return true;
     }
 
-    void connectObjects() {
-        if (pipes.empty() && stations.empty()) {
-            cout << "Нет объектов для соединения!\n";
+    void connectObjects() {
+        if (pipes.empty() && stations.empty()) {
+            cout << "Нет объектов для соединения!\n";
+            return;
+        }
+        
+        viewAll();
+        
+        cout << "\nТипы соединений:\n";
+        cout << "1. КС -> КС\n";
+        cout << "2. КС -> Труба\n";
+        cout << "3. Труба -> КС\n";
+        cout << "4. Труба -> Труба\n";
+        
+        int connectionType = InputValidator::getIntInput("Выберите тип соединения: ", 1, 4);
+        
+        int startId, endId;
+        string startPrompt, endPrompt;
+        
+        switch (connectionType) {
+            case 1: // КС -> КС
+                startPrompt = "Введите ID КС входа: ";
+                endPrompt = "Введите ID КС выхода: ";
+                break;
+            case 2: // КС -> Труба
+                startPrompt = "Введите ID КС входа: ";
+                endPrompt = "Введите ID трубы выхода: ";
+                break;
+            case 3: // Труба -> КС
+                startPrompt = "Введите ID трубы входа: ";
+                endPrompt = "Введите ID КС выхода: ";
+                break;
+            case 4: // Труба -> Труба
+                startPrompt = "Введите ID трубы входа: ";
+                endPrompt = "Введите ID трубы выхода: ";
+                break;
+        }
+        
+        startId = InputValidator::getIntInput(startPrompt, 1);
+        endId = InputValidator::getIntInput(endPrompt, 1);
+        
+        int diameter = InputValidator::getDiameterInput("Введите диаметр соединяющей трубы");
+        
+        // Проверка возможности соединения
+        if (!canConnectObjects(startId, endId, diameter)) {
+            return;
+        }
+        
+        // Определение типов объектов
+        auto [isStartStation, startIndex] = getObjectInfo(startId);
+        auto [isEndStation, endIndex] = getObjectInfo(endId);
+        
+        // Поиск доступной трубы
+        int pipeIndex = findAvailablePipeByDiameter(diameter);
+        
+        if (pipeIndex != -1) {
+            // Используем существующую трубу
+            pipes[pipeIndex].inUse = true;
+            pipes[pipeIndex].startId = startId;
+            pipes[pipeIndex].endId = endId;
+            pipes[pipeIndex].startType = determineConnectionType(isStartStation, isEndStation);
+            pipes[pipeIndex].endType = pipes[pipeIndex].startType; // для простоты
+            
+            NetworkConnection conn;
+            conn.pipeId = pipes[pipeIndex].id;
+            conn.startId = startId;
+            conn.endId = endId;
+            conn.startType = determineConnectionType(isStartStation, isEndStation);
+            conn.endType = conn.startType;
+            network.push_back(conn);
+            applyNetworkDelta(makePipeDelta(ARC_ADDED, conn.pipeId, startId, endId));
+            
+            string startTypeStr = isStartStation ? "КС" : "Труба";
+            string endTypeStr = isEndStation ? "КС" : "Труба";
+            
+            cout << "Соединение создано: " << startTypeStr << " " << startId
+                 << " -> " << endTypeStr << " " << endId
+                 << " (труба ID: " << pipes[pipeIndex].id << ")\n";
+            
+            logger.log("Создано соединение",
+                      startTypeStr + " " + to_string(startId) + " -> " +
+                      endTypeStr + " " + to_string(endId) +
+                      ", Труба ID: " + to_string(pipes[pipeIndex].id));
+        } else {
+            // Создаем новую трубу
+            cout << "Свободной трубы диаметром " << diameter << " мм не найдено.\n";
+            cout << "Создание новой трубы для соединения...\n";
+            
+            Pipe newPipe;
+            if (!issueId(nextPipeId, newPipe.id)) return;
+            newPipe.name = InputValidator::getStringInput("Введите название соединяющей трубы: ");
+            newPipe.length = InputValidator::getDoubleInput("Введите длину соединяющей трубы (км): ", 0.001);
+            newPipe.diameter = diameter;
+            newPipe.underRepair = false;
+            newPipe.inUse = true;
+            newPipe.startId = startId;
+            newPipe.endId = endId;
+            newPipe.startType = determineConnectionType(isStartStation, isEndStation);
+            newPipe.endType = newPipe.startType;
+            
+            pipes.push_back(newPipe);
+            pipeIdIndex.set(newPipe.id, pipes.size() - 1);
+            
+            NetworkConnection conn;
+            conn.pipeId = newPipe.id;
+            conn.startId = startId;
+            conn.endId = endId;
+            conn.startType = determineConnectionType(isStartStation, isEndStation);
+            conn.endType = conn.startType;
+            network.push_back(conn);
+            applyNetworkDelta(makePipeDelta(ARC_ADDED, conn.pipeId, startId, endId));
+            
+            string startTypeStr = isStartStation ? "КС" : "Труба";
+            string endTypeStr = isEndStation ? "КС" : "Труба";
+            
+            cout << "Создана и соединена новая труба ID: " << newPipe.id << "\n";
+            cout << "Соединение: " << startTypeStr << " " << startId
+                 << " -> " << endTypeStr << " " << endId << "\n";
+            
+            logger.log("Создание и соединение новой трубы",
+                      "Труба ID: " + to_string(newPipe.id) + ", " + newPipe.name +
+                      ", " + startTypeStr + " " + to_string(startId) +
+                      " -> " + endTypeStr + " " + to_string(endId));
+        }
+    }
+
+    void disconnectPipe() {
+        if (network.empty()) {
+            cout << "Нет соединений в сети!\n";
+            return;
+        }
+        
+        viewNetwork();
+        
+        int pipeId = InputValidator::getIntInput("Введите ID трубы для разъединения: ", 1);
+        int pipeIndex = findPipeIndexById(pipeId);
+        
+        if (pipeIndex == -1) {
+            cout << "Труба с ID " << pipeId << " не найдена!\n";
+            return;
+        }
+        
+        if (!pipes[pipeIndex].inUse) {
+            cout << "Труба не используется в сети!\n";
+            return;
+        }
+        
+        // Удаляем из сети
+        auto it = remove_if(network.begin(), network.end(),
+                           [pipeId](const NetworkConnection& conn) { return conn.pipeId == pipeId; });
+        network.erase(it, network.end());
+        applyNetworkDelta(makePipeDelta(ARC_REMOVED, pipeId));
+        
+        // Сбрасываем флаг использования в трубе
+        pipes[pipeIndex].inUse = false;
+        pipes[pipeIndex].startId = 0;
+        pipes[pipeIndex].endId = 0;
+        
+        cout << "Труба ID: " << pipeId << " отключена от сети.\n";
+        logger.log("Отключение трубы от сети", "Труба ID: " + to_string(pipeId));
+    }
+
+    // Таблица ориентиров для ALT, перестраивается при смене версии графа
+    const LandmarkTable& getLandmarks() const {
+        const NetworkGraph& g = getGraph();
+        if (landmarks.getVersion() != g.getVersion()) {
+            landmarks.build(g, LANDMARK_COUNT);
+        }
+        return landmarks;
+    }
+
+    // Остовный лес путей наибольшей пропускной способности, перестраивается
+    // при смене версии графа (изменение диаметра, длины или ремонт трубы)
+    const WidestPathTree& getWidestPathTree() const {
+        const NetworkGraph& g = getGraph();
+        if (widestPathTree.getVersion() != g.getVersion()) {
+            widestPathTree.build(g);
+        }
+        return widestPathTree;
+    }
+
+    // Дерево кратчайших путей от вершины-источника: расстояния служат потенциалами
+    // приведенных стоимостей, повторные запросы от того же источника их не пересчитывают
+    const ShortestPathTree& getSourcePotentials(int sourceNode) const {
+        const NetworkGraph& g = getGraph();
+        if (potentialCacheVersion != g.getVersion()) {
+            potentialCache.clear();
+            potentialCacheVersion = g.getVersion();
+        }
+        auto it = potentialCache.find(sourceNode);
+        if (it != potentialCache.end()) return it->second;
+        if ((int)potentialCache.size() >= POTENTIAL_CACHE_SIZE) potentialCache.clear();
+        return potentialCache[sourceNode] = ShortestPathSolver(g).shortestPathTree(sourceNode);
+    }
+
+    // Дерево Гомори-Ху, перестраивается при смене версии графа: изменение
+    // диаметра, длины или статуса ремонта трубы меняет ее пропускную способность
+    const GomoryHuTree& getGomoryHuTree() const {
+        const NetworkGraph& g = getGraph();
+        if (gomoryHuTree.getVersion() != g.getVersion()) {
+            gomoryHuTree.build(g);
+        }
+        return gomoryHuTree;
+    }
+
+    // Иерархия сжатия, перестраивается при смене версии графа (в т.ч. при ремонте трубы)
+    const ContractionHierarchy& getContractionHierarchy() const {
+        const NetworkGraph& g = getGraph();
+        if (contractionHierarchy.getVersion() != g.getVersion()) {
+            contractionHierarchy.build(g);
+        }
+        return contractionHierarchy;
+    }
+
+    // Настраиваемая иерархия: полностью строится только при изменении топологии
+    // (изменения весов труб переносятся в нее в applyNetworkDelta)
+    const CustomizableHierarchy& getCustomizableHierarchy() const {
+        const NetworkGraph& g = getGraph();
+        if (customizableHierarchy.getVersion() != g.getVersion()) {
+            customizableHierarchy.build(g);
+        }
+        return customizableHierarchy;
+    }
+
+    // Поиск кратчайшего пути выбранным алгоритмом (индексы вершин графа getGraph())
+    ShortestPathResult findRoute(int startId, int endId, ShortestPathAlgorithm algorithm) const {
+        const NetworkGraph& g = getGraph();
+        
+        int startIndex = g.nodeIndex(startId);
+        int endIndex = g.nodeIndex(endId);
+        if (startIndex == -1 || endIndex == -1) {
+            return {};
+        }
+        
+        ShortestPathSolver solver(g);
+        switch (algorithm) {
+            case BIDIRECTIONAL_DIJKSTRA:
+                return solver.bidirectional(startIndex, endIndex);
+            case ALT_ASTAR: {
+                const LandmarkTable& table = getLandmarks();
+                return solver.dijkstra(startIndex, endIndex,
+                                       [&table, endIndex](int v) { return table.lowerBound(v, endIndex); });
+            }
+            case CONTRACTION_HIERARCHY:
+                return getContractionHierarchy().query(startIndex, endIndex);
+            case CUSTOMIZABLE_HIERARCHY:
+                return getCustomizableHierarchy().query(startIndex, endIndex);
+            default:
+                return solver.dijkstra(startIndex, endIndex);
+        }
+    }
+
+    // Кратчайший путь: расстояние и ID объектов на пути. Для потока запросов
+    // к редко меняющейся сети - CONTRACTION_HIERARCHY (время запроса - микросекунды)
+    pair<double, vector<int>> shortestPath(int startId, int endId, ShortestPathAlgorithm algorithm) const {
+        ShortestPathResult result = findRoute(startId, endId, algorithm);
+        
+        // Конвертируем индексы обратно в ID объектов
+        const NetworkGraph& g = getGraph();
+        vector<int> objectPath;
+        for (int v : result.nodes) {
+            objectPath.push_back(g.nodeId(v));
+        }
+        return {result.distance, objectPath};
+    }
+
+    // Алгоритм Дейкстры для поиска кратчайшего пути
+    pair<double, vector<int>> dijkstraShortestPath(int startId, int endId) const {
+        return shortestPath(startId, endId, DIJKSTRA);
+    }
+
+    // Матрица расстояний: values[i * targetIds.size() + j] - от sourceIds[i] до targetIds[j]
+    struct DistanceMatrix {
+        vector<int> sourceIds;
+        vector<int> targetIds;
+        vector<double> values;
+    };
+
+    // Строки матрицы [rowBegin, rowEnd) в out: по одному поиску до всех целей
+    // на строку, строки считаются параллельно, у каждого потока свои рабочие массивы
+    void computeDistanceRows(const vector<int>& sourceIds, const vector<int>& targetIds,
+                             int rowBegin, int rowEnd, double* out) const {
+        const NetworkGraph& g = getGraph();
+        int cols = targetIds.size();
+        vector<int> targetNodes(cols);
+        vector<char> isTarget(g.nodeCount(), 0);
+        int targetCount = 0;
+        for (int j = 0; j < cols; ++j) {
+            targetNodes[j] = g.nodeIndex(targetIds[j]);
+            if (targetNodes[j] != -1 && !isTarget[targetNodes[j]]) {
+                isTarget[targetNodes[j]] = 1;
+                targetCount++;
+            }
+        }
+        
+        ShortestPathSolver solver(g);
+        vector<SearchWorkspace> workspaces(parallelWorkers());
+        // Строка - целый проход Дейкстры, поэтому потоки берут строки по одной
+        parallelFor(rowEnd - rowBegin, [&](int worker, int row) {
+            int sourceId = sourceIds[rowBegin + row];
+            int source = g.nodeIndex(sourceId);
+            double* values = out + static_cast<size_t>(row) * cols;
+            if (source != -1) {
+                solver.distancesTo(source, isTarget, targetCount, workspaces[worker]);
+            }
+            for (int j = 0; j < cols; ++j) {
+                if (targetIds[j] == sourceId) {
+                    values[j] = 0;
+                } else if (source == -1 || targetNodes[j] == -1) {
+                    values[j] = ShortestPathSolver::INF;  // КС не подключена к сети
+                } else {
+                    values[j] = workspaces[worker].dist(targetNodes[j]);
+                }
+            }
+        }, 1);
+    }
+
+    // Плотная матрица расстояний между КС (в памяти)
+    DistanceMatrix distanceMatrix(const vector<int>& sourceIds, const vector<int>& targetIds) const {
+        DistanceMatrix matrix{sourceIds, targetIds, {}};
+        matrix.values.resize(sourceIds.size() * targetIds.size());
+        computeDistanceRows(sourceIds, targetIds, 0, sourceIds.size(), matrix.values.data());
+        return matrix;
+    }
+
+    // Запись матрицы в двоичный файл блоками строк, без хранения всей матрицы в памяти.
+    // Формат: "DMX1", int32 число строк и столбцов, int32 ID источников и целей,
+    // затем double по строкам (бесконечность - путь не существует).
+    bool writeDistanceMatrix(const vector<int>& sourceIds, const vector<int>& targetIds,
+                             const string& filename) const {
+        ofstream file(filename, ios::binary);
+        if (!file.is_open()) return false;
+        
+        int32_t rows = sourceIds.size();
+        int32_t cols = targetIds.size();
+        file.write("DMX1", 4);
+        file.write(reinterpret_cast<const char*>(&rows), sizeof(rows));
+        file.write(reinterpret_cast<const char*>(&cols), sizeof(cols));
+        for (int id : sourceIds) {
+            int32_t value = id;
+            file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+        for (int id : targetIds) {
+            int32_t value = id;
+            file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+        
+        // Блок - около 4 млн значений (32 МБ), но не меньше одной строки
+        const size_t BLOCK_VALUES = 1 << 22;
+        int blockRows = max<size_t>(1, BLOCK_VALUES / max(1, cols));
+        vector<double> block;
+        for (int rowBegin = 0; rowBegin < rows; rowBegin += blockRows) {
+            int rowEnd = min(rows, rowBegin + blockRows);
+            block.resize(static_cast<size_t>(rowEnd - rowBegin) * cols);
+            computeDistanceRows(sourceIds, targetIds, rowBegin, rowEnd, block.data());
+            file.write(reinterpret_cast<const char*>(block.data()), block.size() * sizeof(double));
+        }
+        return file.good();
+    }
+
+    // Расчет максимального потока выбранным алгоритмом на графе сети
+    // При limitStations КС разделяются на вход и выход, и поток через КС
+    // ограничен ее производительностью (в том числе у источника и стока)
+    MaxFlowResult computeMaxFlow(int sourceId, int sinkId, MaxFlowAlgorithm algorithm,
+                                 bool withPaths = false, bool limitStations = false) const {
+        const NetworkGraph& g = limitStations ? getSplitGraph() : getGraph();
+        
+        int source = g.nodeIndex(sourceId);
+        int sink = g.nodeIndex(sinkId);
+        if (source == -1 || sink == -1) {
+            return {};
+        }
+        sink = g.exitNode(sink);
+        
+        MaxFlowResult result = MaxFlowSolver(g, source, sink).run(algorithm, withPaths);
+        tuple<int, int, bool> key{sourceId, sinkId, limitStations};
+        if (!maxFlowCache.count(key) && (int)maxFlowCache.size() >= MAX_FLOW_CACHE_SIZE) maxFlowCache.clear();
+        maxFlowCache[key] = {networkVersion, stationsVersion, result};
+        return result;
+    }
+
+    bool hasPreviousMaxFlow(int sourceId, int sinkId, bool limitStations) const {
+        return maxFlowCache.count({sourceId, sinkId, limitStations}) > 0;
+    }
+
+    // Инкрементальный пересчет от предыдущего потока для той же пары КС
+    MaxFlowResult recomputeMaxFlow(int sourceId, int sinkId, bool withPaths = false, bool limitStations = false) const {
+        auto it = maxFlowCache.find({sourceId, sinkId, limitStations});
+        if (it == maxFlowCache.end()) {
+            return computeMaxFlow(sourceId, sinkId, DINIC, withPaths, limitStations);
+        }
+        
+        const NetworkGraph& g = limitStations ? getSplitGraph() : getGraph();
+        int source = g.nodeIndex(sourceId);
+        int sink = g.nodeIndex(sinkId);
+        if (source == -1 || sink == -1) {
+            maxFlowCache.erase(it);
+            return {};
+        }
+        sink = g.exitNode(sink);
+        
+        MaxFlowCacheEntry& entry = it->second;
+        if (entry.networkVersion == networkVersion && entry.stationsVersion == stationsVersion) {
+            // Сеть не менялась: поток по ребрам остается в силе
+            if (withPaths && entry.result.paths.empty()) {
+                entry.result.paths = MaxFlowSolver::decompose(g, source, sink, entry.result.arcFlow);
+            }
+        } else {
+            entry.result = MaxFlowSolver(g, source, sink).warmStart(entry.result.pipeFlow, withPaths);
+            entry.networkVersion = networkVersion;
+            entry.stationsVersion = stationsVersion;
+        }
+        return entry.result;
+    }
+
+    static MinCostFlowAlgorithm selectMinCostFlowAlgorithm() {
+        cout << "\nАлгоритм расчета потока минимальной стоимости:\n";
+        cout << "1. Последовательные кратчайшие пути (потенциалы Джонсона)\n";
+        cout << "2. Масштабирование стоимостей (для больших сетей)\n";
+        int choice = InputValidator::getIntInput("Выберите алгоритм: ", 1, 2);
+        return choice == 1 ? SUCCESSIVE_SHORTEST_PATHS : COST_SCALING;
+    }
+
+    static MaxFlowAlgorithm selectMaxFlowAlgorithm() {
+        cout << "\nАлгоритм расчета потока:\n";
+        cout << "1. Эдмондс-Карп\n";
+        cout << "2. Диниц\n";
+        cout << "3. Проталкивание предпотока (highest-label)\n";
+        int choice = InputValidator::getIntInput("Выберите алгоритм: ", 1, 3);
+        switch (choice) {
+            case 1: return EDMONDS_KARP;
+            case 2: return DINIC;
+            default: return PUSH_RELABEL;
+        }
+    }
+
+    void viewNetwork() const {
+        if (network.empty()) {
+            cout << "Газотранспортная сеть пуста.\n";
+            return;
+        }
+        
+        cout << "\nГазотранспортная сеть (" << network.size() << " соединений)\n";
+        cout << "Труба | Диаметр | Длина | Начало -> Конец | Тип соединения | Вес | Произв. | Статус\n";
+        cout << string(110, '-') << endl;
+        
+        for (const auto& conn : network) {
+            int pipeIndex = findPipeIndexById(conn.pipeId);
+            if (pipeIndex != -1) {
+                const Pipe& pipe = pipes[pipeIndex];
+                
+                string startStr, endStr;
+                if (conn.startType == STATION_TO_STATION || conn.startType == STATION_TO_PIPE) {
+                    startStr = "КС" + to_string(conn.startId);
+                } else {
+                    startStr = "Тр" + to_string(conn.startId);
+                }
+                
+                if (conn.endType == STATION_TO_STATION || conn.endType == PIPE_TO_STATION) {
+                    endStr = "КС" + to_string(conn.endId);
+                } else {
+                    endStr = "Тр" + to_string(conn.endId);
+                }
+                
+                string connTypeStr;
+                switch (conn.startType) {
+                    case STATION_TO_STATION: connTypeStr = "КС-КС"; break;
+                    case STATION_TO_PIPE: connTypeStr = "КС-Труба"; break;
+                    case PIPE_TO_STATION: connTypeStr = "Труба-КС"; break;
+                    case PIPE_TO_PIPE: connTypeStr = "Труба-Труба"; break;
+                }
+                
+                cout << setw(5) << pipe.id << " | "
+                     << setw(7) << pipe.diameter << " | "
+                     << setw(6) << fixed << setprecision(2) << pipe.length << " | "
+                     << setw(5) << startStr << " -> "
+                     << setw(9) << endStr << " | "
+                     << setw(13) << connTypeStr << " | "
+                     << setw(4) << fixed << setprecision(1) << pipe.getWeight() << " | "
+                     << setw(8) << fixed << setprecision(1) << pipe.getCapacity() << " | "
+                     << (pipe.underRepair ? "В ремонте" : "Работает") << endl;
+            }
+        }
+        
+        // Статистика
+        cout << "\nСтатистика сети:\n";
+        cout << "Всего соединений: " << network.size() << endl;
+        
+        set<int> connectedStations;
+        set<int> connectedPipes;
+        for (const auto& conn : network) {
+            auto [isStartStation, startIdx] = getObjectInfo(conn.startId);
+            auto [isEndStation, endIdx] = getObjectInfo(conn.endId);
+            
+            if (isStartStation) {
+                connectedStations.insert(conn.startId);
+            } else {
+                connectedPipes.insert(conn.startId);
+            }
+            
+            if (isEndStation) {
+                connectedStations.insert(conn.endId);
+            } else {
+                connectedPipes.insert(conn.endId);
+            }
+        }
+        
+        cout << "Подключенных КС: " << connectedStations.size() << " из " << stations.size() << endl;
+        cout << "Подключенных труб: " << connectedPipes.size() << " из " << pipes.size() << endl;
+    }
+
+    void topologicalSort() const {
+        if (network.empty()) {
+            cout << "Сеть пуста, сортировка невозможна.\n";
+            return;
+        }
+        
+        // Построение графа только для КС
+        map<int, vector<int>> adjList;
+        map<int, int> inDegree;
+        
+        // Инициализация степеней входа для всех станций
+        for (const auto& station : stations) {
+            inDegree[station.id] = 0;
+        }
+        
+        // Построение списка смежности и подсчет степеней входа
+        // Учитываем только соединения между станциями
+        for (const auto& conn : network) {
+            auto [isStartStation, startIdx] = getObjectInfo(conn.startId);
+            auto [isEndStation, endIdx] = getObjectInfo(conn.endId);
+            
+            if (isStartStation && isEndStation) {
+                adjList[conn.startId].push_back(conn.endId);
+                inDegree[conn.endId]++;
+            }
+        }
+        
+        // Алгоритм Кана
+        vector<int> result;
+        vector<int> zeroDegreeNodes;
+        
+        for (const auto& [node, degree] : inDegree) {
+            if (degree == 0) {
+                zeroDegreeNodes.push_back(node);
+            }
+        }
+        
+        while (!zeroDegreeNodes.empty()) {
+            int node = zeroDegreeNodes.back();
+            zeroDegreeNodes.pop_back();
+            result.push_back(node);
+            
+            for (int neighbor : adjList[node]) {
+                inDegree[neighbor]--;
+                if (inDegree[neighbor] == 0) {
+                    zeroDegreeNodes.push_back(neighbor);
+                }
+            }
+        }
+        
+        // Проверка на циклы
+        if (result.size() != stations.size()) {
+            cout << "Обнаружен цикл в сети КС! Сортировка невозможна.\n";
+            
+            // Поиск циклических зависимостей
+            set<int> sortedStations(result.begin(), result.end());
+            cout << "КС, образующие циклы: ";
+            bool first = true;
+            for (const auto& station : stations) {
+                if (sortedStations.find(station.id) == sortedStations.end()) {
+                    if (!first) cout << ", ";
+                    cout << station.id << " (" << station.name << ")";
+                    first = false;
+                }
+            }
+            cout << endl;
+            return;
+        }
+        
+        // Вывод результата
+        cout << "\nТопологическая сортировка КС:\n";
+        for (size_t i = 0; i < result.size(); ++i) {
+            int stationIndex = findStationIndexById(result[i]);
+            if (stationIndex != -1) {
+                cout << (i + 1) << ". КС ID: " << result[i]
+                     << " (" << stations[stationIndex].name << ")\n";
+            }
+        }
+    }
+
+    // Поиск кратчайшего пути между КС
+    void findShortestPath() {
+        if (stations.size() < 2) {
+            cout << "Для поиска пути нужно как минимум 2 КС!\n";
+            return;
+        }
+        
+        viewAll();
+        
+        cout << "\nПоиск кратчайшего пути между КС:\n";
+        int startId = InputValidator::getIntInput("Введите ID начальной КС: ", 1);
+        int endId = InputValidator::getIntInput("Введите ID конечной КС: ", 1);
+        
+        // Проверка существования КС
+        int startIndex = findStationIndexById(startId);
+        int endIndex = findStationIndexById(endId);
+        
+        if (startIndex == -1) {
+            cout << "КС с ID " << startId << " не найдена!\n";
+            return;
+        }
+        
+        if (endIndex == -1) {
+            cout << "КС с ID " << endId << " не найдена!\n";
+            return;
+        }
+        
+        cout << "\nАлгоритм поиска пути:\n";
+        cout << "1. Дейкстра\n";
+        cout << "2. Двунаправленный Дейкстра\n";
+        cout << "3. A* с ориентирами (ALT)\n";
+        cout << "4. Иерархия сжатия (CH)\n";
+        cout << "5. Настраиваемая иерархия сжатия (CCH)\n";
+        int algorithmChoice = InputValidator::getIntInput("Выберите алгоритм: ", 1, 5);
+        const ShortestPathAlgorithm algorithms[] = {DIJKSTRA, BIDIRECTIONAL_DIJKSTRA, ALT_ASTAR,
+                                                    CONTRACTION_HIERARCHY, CUSTOMIZABLE_HIERARCHY};
+        ShortestPathAlgorithm algorithm = algorithms[algorithmChoice - 1];
+        
+        if (algorithm == CONTRACTION_HIERARCHY && contractionHierarchy.getVersion() != getGraph().getVersion()) {
+            auto buildStart = chrono::steady_clock::now();
+            const ContractionHierarchy& hierarchy = getContractionHierarchy();
+            cout << "Иерархия сжатия построена: " << hierarchy.shortcutCount() << " сокращений, "
+                 << fixed << setprecision(3) << elapsedMs(buildStart) << " мс\n";
+        }
+        if (algorithm == CUSTOMIZABLE_HIERARCHY && customizableHierarchy.getVersion() != getGraph().getVersion()) {
+            auto buildStart = chrono::steady_clock::now();
+            const CustomizableHierarchy& hierarchy = getCustomizableHierarchy();
+            cout << "Настраиваемая иерархия построена: " << hierarchy.edgeCount() << " ребер, "
+                 << fixed << setprecision(3) << elapsedMs(buildStart) << " мс\n";
+        }
+        
+        auto startTime = chrono::steady_clock::now();
+        ShortestPathResult route = findRoute(startId, endId, algorithm);
+        double elapsed = elapsedMs(startTime);
+        
+        const NetworkGraph& g = getGraph();
+        double distance = route.distance;
+        vector<int> path;
+        for (int v : route.nodes) {
+            path.push_back(g.nodeId(v));
+        }
+        
+        cout << "Обработано вершин: " << route.settled << ", время: "
+             << fixed << setprecision(3) << elapsed << " мс\n";
+        
+        if (distance < numeric_limits<double>::infinity()) {
+            cout << "\nКратчайший путь найден!\n";
+            cout << "Общее расстояние: " << fixed << setprecision(2) << distance << " км\n";
+            cout << "Путь: ";
+            
+            for (size_t i = 0; i < path.size(); ++i) {
+                auto [isStation, idx] = getObjectInfo(path[i]);
+                string type = isStation ? "КС" : "Труба";
+                string name = isStation ? stations[idx].name : pipes[idx].name;
+                
+                cout << type << " " << path[i] << " (" << name << ")";
+                if (i < path.size() - 1) {
+                    cout << " -> ";
+                }
+            }
+            cout << endl;
+            
+            // Детализация по трубам на пути
+            cout << "\nДетали пути:\n";
+            double totalLength = 0;
+            for (int a : route.arcs) {
+                const Pipe& pipe = pipes[findPipeIndexById(g.arc(a).pipeId)];
+                cout << "Труба ID: " << pipe.id << " (" << pipe.name << "), "
+                     << "Длина: " << pipe.length << " км, "
+                     << "Диаметр: " << pipe.diameter << " мм, "
+                     << "Вес: " << pipe.getWeight() << endl;
+                totalLength += pipe.length;
+            }
+            cout << "Суммарная длина труб на пути: " << totalLength << " км\n";
+        } else {
+            cout << "Путь между КС " << startId << " и КС " << endId << " не найден!\n";
+        }
+        
+        logger.log("Поиск кратчайшего пути",
+                  "От КС: " + to_string(startId) + " до КС: " + to_string(endId) +
+                  ", Расстояние: " + to_string(distance));
+    }
+
+    // Путь наибольшей пропускной способности между КС: маршрут, самая слабая
+    // труба которого имеет максимальную производительность (для одной крупной поставки)
+    void findWidestPath() {
+        if (stations.size() < 2) {
+            cout << "Для поиска пути нужно как минимум 2 КС!\n";
+            return;
+        }
+        
+        viewAll();
+        
+        cout << "\nПоиск пути наибольшей пропускной способности между КС:\n";
+        int startId = InputValidator::getIntInput("Введите ID начальной КС: ", 1);
+        int endId = InputValidator::getIntInput("Введите ID конечной КС: ", 1);
+        
+        if (findStationIndexById(startId) == -1) {
+            cout << "КС с ID " << startId << " не найдена!\n";
+            return;
+        }
+        if (findStationIndexById(endId) == -1) {
+            cout << "КС с ID " << endId << " не найдена!\n";
+            return;
+        }
+        
+        cout << "\nАлгоритм поиска:\n";
+        cout << "1. Дейкстра по самой слабой трубе\n";
+        cout << "2. Максимальное остовное дерево\n";
+        int algorithmChoice = InputValidator::getIntInput("Выберите алгоритм: ", 1, 2);
+        
+        const NetworkGraph& g = getGraph();
+        int startIndex = g.nodeIndex(startId);
+        int endIndex = g.nodeIndex(endId);
+        if (startIndex == -1 || endIndex == -1) {
+            cout << "Путь между КС " << startId << " и КС " << endId << " не найден!\n";
+            return;
+        }
+        
+        if (algorithmChoice == 2 && widestPathTree.getVersion() != g.getVersion()) {
+            auto buildStart = chrono::steady_clock::now();
+            getWidestPathTree();
+            cout << "Остовное дерево построено за " << fixed << setprecision(3) << elapsedMs(buildStart) << " мс\n";
+        }
+        
+        WidestPathResult route;
+        auto startTime = chrono::steady_clock::now();
+        if (algorithmChoice == 1) {
+            ShortestPathSolver(g).widest(startIndex, endIndex, route);
+        } else {
+            getWidestPathTree().query(g, startIndex, endIndex, route);
+        }
+        double elapsed = elapsedMs(startTime);
+        cout << "Время: " << fixed << setprecision(3) << elapsed << " мс\n";
+        
+        if (route.nodes.empty()) {
+            cout << "Путь между КС " << startId << " и КС " << endId << " не найден!\n";
+        } else if (route.arcs.empty()) {
+            cout << "Начальная и конечная КС совпадают.\n";
+        } else {
+            cout << "\nПуть найден! Пропускная способность: " << fixed << setprecision(2) << route.width << endl;
+            cout << "Путь: ";
+            for (size_t i = 0; i < route.nodes.size(); ++i) {
+                int id = g.nodeId(route.nodes[i]);
+                auto [isStation, idx] = getObjectInfo(id);
+                cout << (isStation ? "КС " : "Труба ") << id << " ("
+                     << (isStation ? stations[idx].name : pipes[idx].name) << ")";
+                if (i < route.nodes.size() - 1) cout << " -> ";
+            }
+            cout << endl;
+            
+            cout << "\nДетали пути:\n";
+            double totalLength = 0;
+            for (int a : route.arcs) {
+                const Pipe& pipe = pipes[findPipeIndexById(g.arc(a).pipeId)];
+                cout << "Труба ID: " << pipe.id << " (" << pipe.name << "), "
+                     << "Длина: " << pipe.length << " км, "
+                     << "Диаметр: " << pipe.diameter << " мм, "
+                     << "Производительность: " << pipe.getCapacity() << endl;
+                totalLength += pipe.length;
+            }
+            cout << "Суммарная длина труб на пути: " << totalLength << " км\n";
+        }
+        
+        logger.log("Поиск пути наибольшей пропускной способности",
+                  "От КС: " + to_string(startId) + " до КС: " + to_string(endId) +
+                  ", Пропускная способность: " + to_string(route.width));
+    }
+
+    // k кратчайших маршрутов без циклов между КС (альтернативы для планирования ремонта)
+    void findAlternativeRoutes() {
+        if (stations.size() < 2) {
+            cout << "Для поиска пути нужно как минимум 2 КС!\n";
+            return;
+        }
+        
+        viewAll();
+        
+        cout << "\nПоиск альтернативных маршрутов между КС:\n";
+        int startId = InputValidator::getIntInput("Введите ID начальной КС: ", 1);
+        int endId = InputValidator::getIntInput("Введите ID конечной КС: ", 1);
+        
+        if (findStationIndexById(startId) == -1) {
+            cout << "КС с ID " << startId << " не найдена!\n";
+            return;
+        }
+        if (findStationIndexById(endId) == -1) {
+            cout << "КС с ID " << endId << " не найдена!\n";
+            return;
+        }
+        if (startId == endId) {
+            cout << "Начальная и конечная КС совпадают!\n";
+            return;
+        }
+        int k = InputValidator::getIntInput("Введите число маршрутов (1-50): ", 1, 50);
+        
+        const NetworkGraph& g = getGraph();
+        int startIndex = g.nodeIndex(startId);
+        int endIndex = g.nodeIndex(endId);
+        vector<ShortestPathResult> routes;
+        auto startTime = chrono::steady_clock::now();
+        if (startIndex != -1 && endIndex != -1) {
+            routes = KShortestPathsSolver(g).run(startIndex, endIndex, k);
+        }
+        double elapsed = elapsedMs(startTime);
+        
+        if (routes.empty()) {
+            cout << "Путь между КС " << startId << " и КС " << endId << " не найден!\n";
+            return;
+        }
+        
+        cout << "Найдено маршрутов: " << routes.size() << " из " << k << ", время: "
+             << fixed << setprecision(3) << elapsed << " мс\n";
+        for (size_t i = 0; i < routes.size(); ++i) {
+            cout << "\nМаршрут " << i + 1 << ": " << fixed << setprecision(2) << routes[i].distance
+                 << " км, труб: " << routes[i].arcs.size() << "\n";
+            for (size_t j = 0; j < routes[i].nodes.size(); ++j) {
+                int id = g.nodeId(routes[i].nodes[j]);
+                cout << (getObjectInfo(id).first ? "КС " : "Труба ") << id;
+                if (j < routes[i].arcs.size()) cout << " -(" << g.arc(routes[i].arcs[j]).pipeId << ")-> ";
+            }
+            cout << endl;
+        }
+        
+        logger.log("Поиск альтернативных маршрутов",
+                  "От КС: " + to_string(startId) + " до КС: " + to_string(endId) +
+                  ", Маршрутов: " + to_string(routes.size()));
+    }
+
+    void findDisjointRoutes() {
+        if (stations.size() < 2) {
+            cout << "Для поиска пути нужно как минимум 2 КС!\n";
             return;
         }
         
         viewAll();
         
-        cout << "\nТипы соединений:\n";
-        cout << "1. КС -> КС\n";
-        cout << "2. КС -> Труба\n";
-        cout << "3. Труба -> КС\n";
-        cout << "4. Труба -> Труба\n";
-        
-        int connectionType = InputValidator::getIntInput("Выберите тип соединения: ", 1, 4);
-        
-        int startId, endId;
-        string startPrompt, endPrompt;
+        cout << "\nПоиск пары маршрутов без общих труб:\n";
+        int startId = InputValidator::getIntInput("Введите ID начальной КС: ", 1);
+        int endId = InputValidator::getIntInput("Введите ID конечной КС: ", 1);
         
-        switch (connectionType) {
-            case 1: // КС -> КС
-                startPrompt = "Введите ID КС входа: ";
-                endPrompt = "Введите ID КС выхода: ";
-                break;
-            case 2: // КС -> Труба
-                startPrompt = "Введите ID КС входа: ";
-                endPrompt = "Введите ID трубы выхода: ";
-                break;
-            case 3: // Труба -> КС
-                startPrompt = "Введите ID трубы входа: ";
-                endPrompt = "Введите ID КС выхода: ";
-                break;
-            case 4: // Труба -> Труба
-                startPrompt = "Введите ID трубы входа: ";
-                endPrompt = "Введите ID трубы выхода: ";
-                break;
+        if (findStationIndexById(startId) == -1) {
+            cout << "КС с ID " << startId << " не найдена!\n";
+            return;
+        }
+        if (findStationIndexById(endId) == -1) {
+            cout << "КС с ID " << endId << " не найдена!\n";
+            return;
+        }
+        if (startId == endId) {
+            cout << "Начальная и конечная КС совпадают!\n";
+            return;
         }
         
-        startId = InputValidator::getIntInput(startPrompt, 1);
-        endId = InputValidator::getIntInput(endPrompt, 1);
-        
-        int diameter = InputValidator::getDiameterInput("Введите диаметр соединяющей трубы");
+        const NetworkGraph& g = getGraph();
+        int startIndex = g.nodeIndex(startId);
+        int endIndex = g.nodeIndex(endId);
+        DisjointPathPair result;
+        auto startTime = chrono::steady_clock::now();
+        if (startIndex != -1 && endIndex != -1) {
+            result = ShortestPathSolver(g).disjointPair(startIndex, endIndex,
+                                                        getSourcePotentials(startIndex));
+        }
+        double elapsed = elapsedMs(startTime);
         
-        // Проверка возможности соединения
-        if (!canConnectObjects(startId, endId, diameter)) {
+        if (result.paths[0].distance == ShortestPathSolver::INF) {
+            cout << "Путь между КС " << startId << " и КС " << endId << " не найден!\n";
             return;
         }
         
-        // Определение типов объектов
-        auto [isStartStation, startIndex] = getObjectInfo(startId);
-        auto [isEndStation, endIndex] = getObjectInfo(endId);
-        
-        // Поиск доступной трубы
-        int pipeIndex = findAvailablePipeByDiameter(diameter);
+        auto printRoute = [&](const ShortestPathResult& route) {
+            for (size_t j = 0; j < route.nodes.size(); ++j) {
+                int id = g.nodeId(route.nodes[j]);
+                cout << (getObjectInfo(id).first ? "КС " : "Труба ") << id;
+                if (j < route.arcs.size()) cout << " -(" << g.arc(route.arcs[j]).pipeId << ")-> ";
+            }
+            cout << endl;
+        };
         
-        if (pipeIndex != -1) {
-            // Используем существующую трубу
-            pipes[pipeIndex].inUse = true;
-            pipes[pipeIndex].startId = startId;
-            pipes[pipeIndex].endId = endId;
-            pipes[pipeIndex].startType = determineConnectionType(isStartStation, isEndStation);
-            pipes[pipeIndex].endType = pipes[pipeIndex].startType; // для простоты
-            
-            NetworkConnection conn;
-            conn.pipeId = pipes[pipeIndex].id;
-            conn.startId = startId;
-            conn.endId = endId;
-            conn.startType = determineConnectionType(isStartStation, isEndStation);
-            conn.endType = conn.startType;
-            network.push_back(conn);
-            
-            string startTypeStr = isStartStation ? "КС" : "Труба";
-            string endTypeStr = isEndStation ? "КС" : "Труба";
-            
-            cout << "Соединение создано: " << startTypeStr << " " << startId
-                 << " -> " << endTypeStr << " " << endId
-                 << " (труба ID: " << pipes[pipeIndex].id << ")\n";
-            
-            logger.log("Создано соединение",
-                      startTypeStr + " " + to_string(startId) + " -> " +
-                      endTypeStr + " " + to_string(endId) +
-                      ", Труба ID: " + to_string(pipes[pipeIndex].id));
+        if (result.totalLength == ShortestPathSolver::INF) {
+            cout << "Двух маршрутов без общих труб нет: все пути проходят через общую трубу.\n"
+                 << "Кратчайший маршрут: " << fixed << setprecision(2) << result.paths[0].distance << " км\n";
+            printRoute(result.paths[0]);
         } else {
-            // Создаем новую трубу
-            cout << "Свободной трубы диаметром " << diameter << " мм не найдено.\n";
-            cout << "Создание новой трубы для соединения...\n";
-            
-            Pipe newPipe;
-            newPipe.id = nextPipeId++;
-            newPipe.name = InputValidator::getStringInput("Введите название соединяющей трубы: ");
-            newPipe.length = InputValidator::getDoubleInput("Введите длину соединяющей трубы (км): ", 0.001);
-            newPipe.diameter = diameter;
-            newPipe.underRepair = false;
-            newPipe.inUse = true;
-            newPipe.startId = startId;
-            newPipe.endId = endId;
-            newPipe.startType = determineConnectionType(isStartStation, isEndStation);
-            newPipe.endType = newPipe.startType;
-            
-            pipes.push_back(newPipe);
-            
-            NetworkConnection conn;
-            conn.pipeId = newPipe.id;
-            conn.startId = startId;
-            conn.endId = endId;
-            conn.startType = determineConnectionType(isStartStation, isEndStation);
-            conn.endType = conn.startType;
-            network.push_back(conn);
-            
-            string startTypeStr = isStartStation ? "КС" : "Труба";
-            string endTypeStr = isEndStation ? "КС" : "Труба";
-            
-            cout << "Создана и соединена новая труба ID: " << newPipe.id << "\n";
-            cout << "Соединение: " << startTypeStr << " " << startId
-                 << " -> " << endTypeStr << " " << endId << "\n";
-            
-            logger.log("Создание и соединение новой трубы",
-                      "Труба ID: " + to_string(newPipe.id) + ", " + newPipe.name +
-                      ", " + startTypeStr + " " + to_string(startId) +
-                      " -> " + endTypeStr + " " + to_string(endId));
+            cout << "Суммарная длина: " << fixed << setprecision(2) << result.totalLength
+                 << " км, время: " << setprecision(3) << elapsed << " мс\n";
+            for (int i = 0; i < 2; ++i) {
+                cout << "\nМаршрут " << i + 1 << ": " << fixed << setprecision(2) << result.paths[i].distance
+                     << " км, труб: " << result.paths[i].arcs.size() << "\n";
+                printRoute(result.paths[i]);
+            }
         }
+        
+        logger.log("Поиск пары маршрутов без общих труб",
+                  "От КС: " + to_string(startId) + " до КС: " + to_string(endId) +
+                  ", Суммарная длина: " + (result.totalLength == ShortestPathSolver::INF ? string("нет пары")
+                                                                     : to_string(result.totalLength)));
     }
 
-    void disconnectPipe() {
-        if (network.empty()) {
-            cout << "Нет соединений в сети!\n";
+    // Критические трубы (мосты) и объекты (точки сочленения): вывод любого из них
+    // в ремонт разделяет сеть. Для каждого - число отрезаемых объектов.
+    void findCriticalElements() {
+        const NetworkGraph& g = getGraph();
+        if (g.nodeCount() == 0) {
+            cout << "Сеть пуста!\n";
             return;
         }
         
-        viewNetwork();
-        
-        int pipeId = InputValidator::getIntInput("Введите ID трубы для разъединения: ", 1);
-        int pipeIndex = findPipeIndexById(pipeId);
+        auto startTime = chrono::steady_clock::now();
+        CriticalElementsResult result = CriticalElementsAnalyzer::analyze(g);
+        double elapsed = elapsedMs(startTime);
+        
+        const size_t shown = 20;
+        cout << "\nКомпонент связности: " << result.components << ", время: "
+             << fixed << setprecision(3) << elapsed << " мс\n";
+        
+        cout << "\nКритические трубы: " << result.bridges.size() << "\n";
+        for (size_t i = 0; i < result.bridges.size() && i < shown; ++i) {
+            const GraphEdge& e = g.arc(result.bridges[i].element);
+            int fromId = g.nodeId(g.tail(result.bridges[i].element));
+            int toId = g.nodeId(e.to);
+            cout << "Труба " << e.pipeId << " (" << (getObjectInfo(fromId).first ? "КС " : "Труба ") << fromId
+                 << " - " << (getObjectInfo(toId).first ? "КС " : "Труба ") << toId
+                 << "): отрезает объектов: " << result.bridges[i].cutOff << "\n";
+        }
         
-        if (pipeIndex == -1) {
-            cout << "Труба с ID " << pipeId << " не найдена!\n";
-            return;
+        cout << "\nКритические объекты: " << result.articulationPoints.size() << "\n";
+        for (size_t i = 0; i < result.articulationPoints.size() && i < shown; ++i) {
+            int id = g.nodeId(result.articulationPoints[i].element);
+            cout << (getObjectInfo(id).first ? "КС " : "Труба ") << id
+                 << ": отрезает объектов: " << result.articulationPoints[i].cutOff << "\n";
+        }
+        if (result.bridges.size() > shown || result.articulationPoints.size() > shown) {
+            cout << "(показаны первые " << shown << " по числу отрезаемых объектов)\n";
         }
         
-        if (!pipes[pipeIndex].inUse) {
-            cout << "Труба не используется в сети!\n";
+        logger.log("Анализ критических элементов",
+                  "Мостов: " + to_string(result.bridges.size()) +
+                  ", Точек сочленения: " + to_string(result.articulationPoints.size()));
+    }
+
+    // Анализ отказов N-1: потеря максимального потока между КС при выводе
+    // в ремонт каждой работающей трубы, трубы упорядочены по убыванию потери
+    void analyzePipeOutages() {
+        if (stations.size() < 2) {
+            cout << "Для расчета потока нужно как минимум 2 КС!\n";
             return;
         }
         
-        // Удаляем из сети
-        auto it = remove_if(network.begin(), network.end(),
-                           [pipeId](const NetworkConnection& conn) { return conn.pipeId == pipeId; });
-        network.erase(it, network.end());
-        
-        // Сбрасываем флаг использования в трубе
-        pipes[pipeIndex].inUse = false;
-        pipes[pipeIndex].startId = 0;
-        pipes[pipeIndex].endId = 0;
+        viewAll();
         
-        cout << "Труба ID: " << pipeId << " отключена от сети.\n";
-        logger.log("Отключение трубы от сети", "Труба ID: " + to_string(pipeId));
-    }
-
-    // Построение графа для алгоритмов (Дейкстра, максимальный поток)
-    pair<map<int, vector<GraphEdge>>, map<int, int>> buildGraphForAlgorithms() const {
-        map<int, vector<GraphEdge>> graph;
-        map<int, int> idToIndex; // маппинг ID объектов в индексы для алгоритмов
+        cout << "\nАнализ отказов труб (N-1):\n";
+        int sourceId = InputValidator::getIntInput("Введите ID источника (начальной КС): ", 1);
+        int sinkId = InputValidator::getIntInput("Введите ID стока (конечной КС): ", 1);
         
-        // Собираем все уникальные узлы (КС и трубы, используемые в сети)
-        set<int> nodes;
-        for (const auto& conn : network) {
-            nodes.insert(conn.startId);
-            nodes.insert(conn.endId);
+        if (findStationIndexById(sourceId) == -1) {
+            cout << "КС с ID " << sourceId << " не найдена!\n";
+            return;
+        }
+        if (findStationIndexById(sinkId) == -1) {
+            cout << "КС с ID " << sinkId << " не найдена!\n";
+            return;
+        }
+        if (sourceId == sinkId) {
+            cout << "Источник и сток не могут быть одинаковыми!\n";
+            return;
         }
+        bool limitStations = InputValidator::getIntInput("Учитывать производительность КС? (1 - да, 0 - нет): ", 0, 1) == 1;
         
-        // Создаем маппинг ID -> индекс
-        int index = 0;
-        for (int nodeId : nodes) {
-            idToIndex[nodeId] = index++;
+        const NetworkGraph& g = limitStations ? getSplitGraph() : getGraph();
+        int source = g.nodeIndex(sourceId);
+        int sink = g.nodeIndex(sinkId);
+        if (source == -1 || sink == -1) {
+            cout << "Невозможно найти путь для потока между указанными КС!\n";
+            return;
         }
         
-        // Добавляем ребра в граф
-        for (const auto& conn : network) {
-            int pipeIndex = findPipeIndexById(conn.pipeId);
-            if (pipeIndex != -1) {
-                const Pipe& pipe = pipes[pipeIndex];
-                
-                GraphEdge forward, backward;
-                
-                // Прямое ребро
-                forward.to = idToIndex[conn.endId];
-                forward.pipeId = conn.pipeId;
-                forward.capacity = pipe.getCapacity();
-                forward.flow = 0;
-                forward.weight = pipe.getWeight();
-                
-                // Обратное ребро (для алгоритма максимального потока)
-                backward.to = idToIndex[conn.startId];
-                backward.pipeId = conn.pipeId;
-                backward.capacity = 0; // начальная пропускная способность обратного ребра = 0
-                backward.flow = 0;
-                backward.weight = pipe.getWeight();
-                
-                // Добавляем ребра в граф
-                int forwardIndex = graph[idToIndex[conn.startId]].size();
-                int backwardIndex = graph[idToIndex[conn.endId]].size();
-                
-                forward.rev = backwardIndex;
-                backward.rev = forwardIndex;
-                
-                graph[idToIndex[conn.startId]].push_back(forward);
-                graph[idToIndex[conn.endId]].push_back(backward);
+        auto start = chrono::steady_clock::now();
+        ContingencyResult result = ContingencyAnalyzer::run(g, source, g.exitNode(sink));
+        double elapsed = elapsedMs(start);
+        
+        cout << "\nМаксимальный поток без отказов: " << fixed << setprecision(1) << result.baseValue << " усл. ед.\n"
+             << "Рассчитано отказов: " << result.outages.size() << ", пропущено труб без потока: "
+             << result.skipped << ", время: " << setprecision(3) << elapsed << " мс\n";
+        
+        const size_t shown = 20;
+        if (!result.outages.empty()) {
+            cout << "\nТруба | Начало -> Конец | Поток по трубе | Поток без трубы | Потеря\n";
+            cout << string(75, '-') << endl;
+            for (size_t i = 0; i < result.outages.size() && i < shown; ++i) {
+                const PipeOutage& outage = result.outages[i];
+                const Pipe& pipe = pipes[findPipeIndexById(outage.pipeId)];
+                double share = result.baseValue > 0 ? outage.loss / result.baseValue * 100 : 0;
+                cout << right << setw(5) << outage.pipeId << " | " << setw(5) << pipe.startId << " -> "
+                     << setw(7) << pipe.endId << " | " << setw(14) << setprecision(1) << fabs(outage.baseFlow)
+                     << " | " << setw(15) << outage.value << " | " << setw(8) << outage.loss
+                     << " (" << setprecision(1) << share << "%)" << left << endl;
+            }
+            if (result.outages.size() > shown) {
+                cout << "(показаны первые " << shown << " по потере потока)\n";
             }
         }
         
-        return {graph, idToIndex};
+        logger.log("Анализ отказов труб",
+                  "От КС: " + to_string(sourceId) + " до КС: " + to_string(sinkId) +
+                  ", Отказов: " + to_string(result.outages.size()) +
+                  ", Наибольшая потеря: " + to_string(result.outages.empty() ? 0.0 : result.outages[0].loss));
     }
 
-    // Алгоритм Дейкстры для поиска кратчайшего пути
-    pair<double, vector<int>> dijkstraShortestPath(int startId, int endId) const {
-        auto [graph, idToIndex] = buildGraphForAlgorithms();
-        
-        if (idToIndex.find(startId) == idToIndex.end() ||
-            idToIndex.find(endId) == idToIndex.end()) {
-            return {numeric_limits<double>::infinity(), {}};
+    // Максимальный поток между парами КС по дереву Гомори-Ху: дерево строится
+    // один раз для версии сети, каждый запрос - подъем по дереву
+    void queryPairMaxFlows() {
+        if (stations.size() < 2) {
+            cout << "Для расчета потока нужно как минимум 2 КС!\n";
+            return;
         }
         
-        int startIndex = idToIndex.at(startId);
-        int endIndex = idToIndex.at(endId);
-        int n = idToIndex.size();
-        
-        vector<double> dist(n, numeric_limits<double>::infinity());
-        vector<int> prev(n, -1);
-        vector<int> prevPipe(n, -1);
-        dist[startIndex] = 0;
-        
-        // Приоритетная очередь для алгоритма Дейкстры
-        using pii = pair<double, int>;
-        priority_queue<pii, vector<pii>, greater<pii>> pq;
-        pq.push({0, startIndex});
+        viewAll();
         
-        while (!pq.empty()) {
-            auto [currentDist, u] = pq.top();
-            pq.pop();
-            
-            if (currentDist > dist[u]) continue;
-            if (u == endIndex) break;
-            
-            for (const auto& edge : graph[u]) {
-                int v = edge.to;
-                double newDist = dist[u] + edge.weight;
-                
-                if (newDist < dist[v]) {
-                    dist[v] = newDist;
-                    prev[v] = u;
-                    prevPipe[v] = edge.pipeId;
-                    pq.push({newDist, v});
-                }
-            }
+        const NetworkGraph& g = getGraph();
+        bool rebuilt = gomoryHuTree.getVersion() != g.getVersion();
+        auto start = chrono::steady_clock::now();
+        const GomoryHuTree& tree = getGomoryHuTree();
+        if (rebuilt) {
+            cout << "\nДерево Гомори-Ху построено: объектов " << g.nodeCount() << ", расчетов потока "
+                 << tree.getCutsComputed() << ", время " << fixed << setprecision(3) << elapsedMs(start) << " мс\n";
         }
+        cout << "\nМаксимальный поток между КС (трубы без учета направления, 0 - выход):\n";
         
-        // Восстановление пути
-        vector<int> path;
-        vector<int> pipePath;
-        
-        if (dist[endIndex] < numeric_limits<double>::infinity()) {
-            // Восстанавливаем путь от конца к началу
-            for (int v = endIndex; v != -1; v = prev[v]) {
-                path.push_back(v);
-                if (v != startIndex && prevPipe[v] != -1) {
-                    pipePath.push_back(prevPipe[v]);
-                }
-            }
-            reverse(path.begin(), path.end());
-            reverse(pipePath.begin(), pipePath.end());
+        int queries = 0;
+        while (true) {
+            int sourceId = InputValidator::getIntInput("Введите ID первой КС (0 - выход): ", 0);
+            if (sourceId == 0) break;
+            int sinkId = InputValidator::getIntInput("Введите ID второй КС: ", 1);
             
-            // Конвертируем индексы обратно в ID объектов
-            map<int, int> indexToId;
-            for (const auto& [id, idx] : idToIndex) {
-                indexToId[idx] = id;
+            if (findStationIndexById(sourceId) == -1) {
+                cout << "КС с ID " << sourceId << " не найдена!\n";
+                continue;
             }
-            
-            vector<int> objectPath;
-            for (int idx : path) {
-                objectPath.push_back(indexToId[idx]);
+            if (findStationIndexById(sinkId) == -1) {
+                cout << "КС с ID " << sinkId << " не найдена!\n";
+                continue;
+            }
+            if (sourceId == sinkId) {
+                cout << "Источник и сток не могут быть одинаковыми!\n";
+                continue;
             }
             
-            return {dist[endIndex], objectPath};
+            int source = g.nodeIndex(sourceId);
+            int sink = g.nodeIndex(sinkId);
+            double value = source == -1 || sink == -1 ? 0.0 : tree.query(source, sink);
+            cout << "Максимальный поток между КС " << sourceId << " и КС " << sinkId << ": "
+                 << fixed << setprecision(1) << value << " усл. ед.\n";
+            ++queries;
         }
         
-        return {numeric_limits<double>::infinity(), {}};
+        logger.log("Потоки между парами КС", "Запросов: " + to_string(queries));
     }
 
-    // Алгоритм Эдмондса-Карпа для максимального потока
-    pair<double, map<pair<int, int>, double>> edmondsKarpMaxFlow(int sourceId, int sinkId) const {
-        auto [graph, idToIndex] = buildGraphForAlgorithms();
-        
-        if (idToIndex.find(sourceId) == idToIndex.end() ||
-            idToIndex.find(sinkId) == idToIndex.end()) {
-            return {0, {}};
+    // Поставка заданного объема между КС с минимальной стоимостью транспорта
+    // (стоимость единицы потока пропорциональна длине трубы)
+    void calculateMinCostFlow() {
+        if (stations.size() < 2) {
+            cout << "Для расчета потока нужно как минимум 2 КС!\n";
+            return;
         }
         
-        int source = idToIndex.at(sourceId);
-        int sink = idToIndex.at(sinkId);
-        int n = idToIndex.size();
+        viewAll();
+        
+        cout << "\nРасчет поставки минимальной стоимости между КС:\n";
+        int sourceId = InputValidator::getIntInput("Введите ID источника (начальной КС): ", 1);
+        int sinkId = InputValidator::getIntInput("Введите ID стока (конечной КС): ", 1);
         
-        // Создаем копию графа для модификации
-        map<int, vector<GraphEdge>> residualGraph = graph;
+        if (findStationIndexById(sourceId) == -1) {
+            cout << "КС с ID " << sourceId << " не найдена!\n";
+            return;
+        }
+        if (findStationIndexById(sinkId) == -1) {
+            cout << "КС с ID " << sinkId << " не найдена!\n";
+            return;
+        }
+        if (sourceId == sinkId) {
+            cout << "Источник и сток не могут быть одинаковыми!\n";
+            return;
+        }
         
-        double maxFlow = 0;
+        bool limitStations = InputValidator::getIntInput("Учитывать производительность КС? (1 - да, 0 - нет): ", 0, 1) == 1;
+        double demand = InputValidator::getDoubleInput("Введите объем поставки (0 - максимально возможный): ", 0.0);
+        if (demand == 0) demand = numeric_limits<double>::infinity();
+        MinCostFlowAlgorithm algorithm = selectMinCostFlowAlgorithm();
+        
+        const NetworkGraph& g = limitStations ? getSplitGraph() : getGraph();
+        int source = g.nodeIndex(sourceId);
+        int sink = g.nodeIndex(sinkId);
+        MinCostFlowResult result;
+        auto start = chrono::steady_clock::now();
+        if (source != -1 && sink != -1) {
+            result = MinCostFlowSolver(g, source, g.exitNode(sink)).run(algorithm, demand);
+        }
+        double elapsed = elapsedMs(start);
         
-        // BFS для поиска увеличивающего пути
-        while (true) {
-            vector<int> parent(n, -1);
-            vector<int> parentEdge(n, -1);
-            queue<int> q;
-            
-            q.push(source);
-            parent[source] = source;
-            
-            while (!q.empty() && parent[sink] == -1) {
-                int u = q.front();
-                q.pop();
-                
-                for (int i = 0; i < residualGraph[u].size(); ++i) {
-                    const auto& edge = residualGraph[u][i];
-                    if (parent[edge.to] == -1 && edge.capacity - edge.flow > 1e-9) {
-                        parent[edge.to] = u;
-                        parentEdge[edge.to] = i;
-                        q.push(edge.to);
-                    }
-                }
-            }
-            
-            // Если не нашли путь до стока
-            if (parent[sink] == -1) break;
-            
-            // Находим минимальную остаточную пропускную способность на пути
-            double pathFlow = numeric_limits<double>::infinity();
-            for (int v = sink; v != source; v = parent[v]) {
-                int u = parent[v];
-                int edgeIdx = parentEdge[v];
-                pathFlow = min(pathFlow, residualGraph[u][edgeIdx].capacity -
-                                         residualGraph[u][edgeIdx].flow);
-            }
-            
-            // Обновляем поток вдоль пути
-            for (int v = sink; v != source; v = parent[v]) {
-                int u = parent[v];
-                int edgeIdx = parentEdge[v];
-                int revIdx = residualGraph[u][edgeIdx].rev;
-                
-                residualGraph[u][edgeIdx].flow += pathFlow;
-                residualGraph[v][revIdx].flow -= pathFlow;
-            }
-            
-            maxFlow += pathFlow;
+        if (result.value <= 0) {
+            cout << "Невозможно найти путь для потока между указанными КС!\n";
+            return;
         }
         
-        // Собираем информацию о потоке на каждом ребре
-        map<pair<int, int>, double> flowMap;
-        map<int, int> indexToId;
-        for (const auto& [id, idx] : idToIndex) {
-            indexToId[idx] = id;
+        cout << "\nДоставлено: " << fixed << setprecision(2) << result.value << " усл. ед.";
+        if (demand != numeric_limits<double>::infinity() && result.value < demand - 1e-9) {
+            cout << " из " << demand << " (больше сеть не пропускает)";
         }
+        cout << "\nСтоимость транспорта: " << result.cost << " (поток * км)\n"
+             << "Время расчета: " << setprecision(3) << elapsed << " мс, "
+             << (algorithm == SUCCESSIVE_SHORTEST_PATHS ? "увеличивающих путей: " : "фаз масштабирования: ")
+             << result.iterations << "\n";
         
-        for (const auto& [uIdx, edges] : graph) {
-            int uId = indexToId[uIdx];
-            for (const auto& edge : edges) {
-                if (edge.capacity > 0) { // только прямые ребра
-                    int vId = indexToId[edge.to];
-                    flowMap[{uId, vId}] = edge.flow;
-                }
-            }
+        cout << "\nТруба | Начало -> Конец | Длина, км | Поток | Стоимость\n";
+        cout << string(60, '-') << endl;
+        for (const auto& conn : network) {
+            if (conn.pipeId >= static_cast<int>(result.pipeFlow.size())) continue;
+            double flow = result.pipeFlow[conn.pipeId];
+            if (flow <= 1e-9) continue;
+            const Pipe& pipe = pipes[findPipeIndexById(conn.pipeId)];
+            cout << right << setw(5) << conn.pipeId << " | " << setw(5) << conn.startId << " -> "
+                 << setw(7) << conn.endId << " | " << setw(9) << setprecision(2) << pipe.length
+                 << " | " << setw(5) << flow << " | " << setw(9) << flow * pipe.length << left << endl;
         }
         
-        return {maxFlow, flowMap};
+        logger.log("Расчет поставки минимальной стоимости",
+                  "От КС: " + to_string(sourceId) + " до КС: " + to_string(sinkId) +
+                  ", Объем: " + to_string(result.value) + ", Стоимость: " + to_string(result.cost));
+    }
+
+    // Балансы всех КС с ненулевой закачкой или отбором
+    vector<pair<int, double>> stationBalances() const {
+        vector<pair<int, double>> balances;
+        for (const auto& station : stations) {
+            if (station.balance != 0) balances.push_back({station.id, station.balance});
+        }
+        return balances;
+    }
+
+    // Установившийся режим по текущей сети: КС с закачкой (баланс > 0) держат
+    // давление sourcePressure, КС с отбором - потребители, проводимость трубы -
+    // ее производительность (расход при разности квадратов давлений 1 МПа^2)
+    HydraulicResult solveHydraulics(double sourcePressure) const {
+        const NetworkGraph& g = getGraph();
+        int n = g.nodeCount();
+        vector<double> conductance(g.pipeIdLimit(), 0.0);
+        for (const auto& pipe : pipes) {
+            if (pipe.id < g.pipeIdLimit()) conductance[pipe.id] = pipe.getCapacity();
+        }
+        vector<double> injection(n, 0.0);
+        vector<char> fixedNodes(n, 0);
+        for (const auto& station : stations) {
+            int u = g.nodeIndex(station.id);
+            if (u == -1 || station.balance == 0) continue;
+            if (station.balance > 0) fixedNodes[u] = 1;
+            else injection[u] = station.balance;
+        }
+        return hydraulicSolver.solve(g, conductance, injection, fixedNodes, sourcePressure);
     }
 
-    void viewNetwork() const {
-        if (network.empty()) {
-            cout << "Газотранспортная сеть пуста.\n";
+    // Давления в узлах и расходы по трубам установившегося режима
+    void calculateHydraulics() {
+        bool hasSource = any_of(stations.begin(), stations.end(),
+                                [](const CompressorStation& station) { return station.balance > 0; });
+        if (!hasSource) {
+            cout << "Нет КС с закачкой (баланс > 0): задайте источники в редактировании КС.\n";
             return;
         }
         
-        cout << "\nГазотранспортная сеть (" << network.size() << " соединений)\n";
-        cout << "Труба | Диаметр | Длина | Начало -> Конец | Тип соединения | Вес | Произв. | Статус\n";
-        cout << string(110, '-') << endl;
-        
-        for (const auto& conn : network) {
-            int pipeIndex = findPipeIndexById(conn.pipeId);
-            if (pipeIndex != -1) {
-                const Pipe& pipe = pipes[pipeIndex];
-                
-                string startStr, endStr;
-                if (conn.startType == STATION_TO_STATION || conn.startType == STATION_TO_PIPE) {
-                    startStr = "КС" + to_string(conn.startId);
-                } else {
-                    startStr = "Тр" + to_string(conn.startId);
-                }
-                
-                if (conn.endType == STATION_TO_STATION || conn.endType == PIPE_TO_STATION) {
-                    endStr = "КС" + to_string(conn.endId);
-                } else {
-                    endStr = "Тр" + to_string(conn.endId);
-                }
-                
-                string connTypeStr;
-                switch (conn.startType) {
-                    case STATION_TO_STATION: connTypeStr = "КС-КС"; break;
-                    case STATION_TO_PIPE: connTypeStr = "КС-Труба"; break;
-                    case PIPE_TO_STATION: connTypeStr = "Труба-КС"; break;
-                    case PIPE_TO_PIPE: connTypeStr = "Труба-Труба"; break;
-                }
-                
-                cout << setw(5) << pipe.id << " | "
-                     << setw(7) << pipe.diameter << " | "
-                     << setw(6) << fixed << setprecision(2) << pipe.length << " | "
-                     << setw(5) << startStr << " -> "
-                     << setw(9) << endStr << " | "
-                     << setw(13) << connTypeStr << " | "
-                     << setw(4) << fixed << setprecision(1) << pipe.getWeight() << " | "
-                     << setw(8) << fixed << setprecision(1) << pipe.getCapacity() << " | "
-                     << (pipe.underRepair ? "В ремонте" : "Работает") << endl;
+        double sourcePressure = InputValidator::getDoubleInput("Давление на КС с закачкой, МПа: ", 0.1, 100.0);
+        auto start = chrono::steady_clock::now();
+        HydraulicResult result = solveHydraulics(sourcePressure);
+        double elapsed = elapsedMs(start);
+        const NetworkGraph& g = getGraph();
+        
+        cout << "\n" << (result.converged ? "Расчет сошелся" : "Расчет не сошелся") << ": итераций Ньютона "
+             << result.iterations << ", невязка закона труб " << scientific << setprecision(2) << result.residual
+             << " МПа^2\n" << fixed << setprecision(3) << "Время: " << elapsed << " мс (анализ ";
+        if (result.symbolicReused) cout << "взят из предыдущего расчета";
+        else cout << result.analyzeMs << " мс";
+        cout << ", разложения " << result.factorMs << " мс), ненулевых в L: " << result.factorNonzeros << "\n";
+        
+        cout << "\nКС | Название | Баланс | Давление, МПа | Подача\n";
+        cout << string(60, '-') << endl;
+        int negative = 0;
+        for (const auto& station : stations) {
+            int u = g.nodeIndex(station.id);
+            cout << right << setw(3) << station.id << " | " << left << setw(10) << station.name << " | "
+                 << right << setw(6) << setprecision(2) << station.balance << " | ";
+            if (u == -1 || std::isnan(result.squaredPressure[u])) {
+                cout << setw(13) << "нет связи";
+            } else if (result.squaredPressure[u] < 0) {
+                cout << setw(13) << "< 0";
+                ++negative;
+            } else {
+                cout << setw(13) << setprecision(3) << sqrt(result.squaredPressure[u]);
             }
+            if (station.balance > 0 && u != -1) cout << " | " << setw(6) << setprecision(3) << result.nodeOutflow[u];
+            cout << left << endl;
+        }
+        if (negative > 0) {
+            cout << "Внимание: у " << negative << " КС отбор больше, чем сеть может подать при заданном давлении!\n";
         }
         
-        // Статистика
-        cout << "\nСтатистика сети:\n";
-        cout << "Всего соединений: " << network.size() << endl;
-        
-        set<int> connectedStations;
-        set<int> connectedPipes;
+        cout << "\nТруба | Начало -> Конец | Расход\n";
+        cout << string(40, '-') << endl;
         for (const auto& conn : network) {
-            auto [isStartStation, startIdx] = getObjectInfo(conn.startId);
-            auto [isEndStation, endIdx] = getObjectInfo(conn.endId);
-            
-            if (isStartStation) {
-                connectedStations.insert(conn.startId);
-            } else {
-                connectedPipes.insert(conn.startId);
-            }
-            
-            if (isEndStation) {
-                connectedStations.insert(conn.endId);
-            } else {
-                connectedPipes.insert(conn.endId);
-            }
+            if (conn.pipeId >= static_cast<int>(result.pipeFlow.size())) continue;
+            cout << right << setw(5) << conn.pipeId << " | " << setw(5) << conn.startId << " -> " << setw(7)
+                 << conn.endId << " | " << setw(8) << setprecision(4) << result.pipeFlow[conn.pipeId] << left << endl;
         }
         
-        cout << "Подключенных КС: " << connectedStations.size() << " из " << stations.size() << endl;
-        cout << "Подключенных труб: " << connectedPipes.size() << " из " << pipes.size() << endl;
+        logger.log("Гидравлический расчет",
+                  "Давление источников: " + to_string(sourcePressure) + " МПа, Итераций: " +
+                  to_string(result.iterations) + (result.converged ? "" : ", не сошелся"));
     }
 
-    void topologicalSort() const {
-        if (network.empty()) {
-            cout << "Сеть пуста, сортировка невозможна.\n";
-            return;
+    // Нестационарный режим за сутки по текущей сети. Граничные условия - КС
+    // с работающими цехами и неотрицательным балансом: давление нагнетания
+    // пропорционально доле работающих цехов. КС с отбором (баланс < 0) -
+    // потребители по суточному графику. Начальное состояние - установившийся
+    // режим при среднем отборе.
+    TransientResult simulateTransient(double dischargePressure, int recordEvery, ostream& out) {
+        const NetworkGraph& g = getGraph();
+        int n = g.nodeCount();
+        vector<double> conductance(g.pipeIdLimit(), 0.0), volume(g.pipeIdLimit(), 0.0);
+        for (const auto& pipe : pipes) {
+            if (pipe.id >= g.pipeIdLimit()) continue;
+            conductance[pipe.id] = pipe.getCapacity();
+            volume[pipe.id] = TransientSimulator::pipeVolume(pipe.diameter, pipe.length);
         }
-        
-        // Построение графа только для КС
-        map<int, vector<int>> adjList;
-        map<int, int> inDegree;
-        
-        // Инициализация степеней входа для всех станций
+        vector<double> setpoint(n, numeric_limits<double>::quiet_NaN());
+        vector<double> withdrawal(n, 0.0), injection(n, 0.0);
+        vector<char> fixedNodes(n, 0);
         for (const auto& station : stations) {
-            inDegree[station.id] = 0;
+            int u = g.nodeIndex(station.id);
+            if (u == -1) continue;
+            if (station.balance < 0) {
+                withdrawal[u] = -station.balance;
+                injection[u] = station.balance;
+            } else if (station.activeWorkshops > 0 && station.totalWorkshops > 0) {
+                setpoint[u] = dischargePressure * station.activeWorkshops / station.totalWorkshops;
+                fixedNodes[u] = 1;
+            }
         }
         
-        // Построение списка смежности и подсчет степеней входа
-        // Учитываем только соединения между станциями
-        for (const auto& conn : network) {
-            auto [isStartStation, startIdx] = getObjectInfo(conn.startId);
-            auto [isEndStation, endIdx] = getObjectInfo(conn.endId);
-            
-            if (isStartStation && isEndStation) {
-                adjList[conn.startId].push_back(conn.endId);
-                inDegree[conn.endId]++;
-            }
+        vector<double> initial(n, 0.0);
+        HydraulicResult steady = hydraulicSolver.solve(g, conductance, injection, fixedNodes, setpoint);
+        for (int u = 0; u < n; ++u) {
+            double squared = steady.squaredPressure[u];
+            if (!std::isnan(squared)) initial[u] = sqrt(max(0.0, squared));
+        }
+        return transientSimulator.run(g, conductance, volume, setpoint, withdrawal, initial, recordEvery, out);
+    }
+    
+    // Запас газа и давления в течение суток с записью состояния труб в файл
+    void runTransientSimulation() {
+        bool hasBoundary = any_of(stations.begin(), stations.end(), [](const CompressorStation& station) {
+            return station.balance >= 0 && station.activeWorkshops > 0;
+        });
+        if (!hasBoundary) {
+            cout << "Нет КС с работающими цехами и неотрицательным балансом: граничных условий нет.\n";
+            return;
         }
         
-        // Алгоритм Кана
-        vector<int> result;
-        vector<int> zeroDegreeNodes;
+        double dischargePressure = InputValidator::getDoubleInput(
+            "Давление нагнетания КС при всех работающих цехах, МПа: ", 0.1, 100.0);
+        int recordEvery = InputValidator::getIntInput("Интервал записи в файл, мин (1-60): ", 1, 60);
+        string filename = InputValidator::getStringInput("Введите имя файла: ");
+        if (filename.find('.') == string::npos) {
+            filename += ".bin";
+        }
+        ofstream file(filename, ios::binary);
+        if (!file.is_open()) {
+            cout << "Ошибка: невозможно создать файл " << filename << endl;
+            return;
+        }
         
-        for (const auto& [node, degree] : inDegree) {
-            if (degree == 0) {
-                zeroDegreeNodes.push_back(node);
-            }
+        auto start = chrono::steady_clock::now();
+        TransientResult result = simulateTransient(dischargePressure, recordEvery, file);
+        double elapsed = elapsedMs(start);
+        double megabytes = file.tellp() / 1048576.0;
+        if (!file.good()) {
+            cout << "Ошибка записи в файл " << filename << endl;
+            return;
         }
         
-        while (!zeroDegreeNodes.empty()) {
-            int node = zeroDegreeNodes.back();
-            zeroDegreeNodes.pop_back();
-            result.push_back(node);
-            
-            for (int neighbor : adjList[node]) {
-                inDegree[neighbor]--;
-                if (inDegree[neighbor] == 0) {
-                    zeroDegreeNodes.push_back(neighbor);
-                }
-            }
+        cout << "\nТруб: " << result.pipes << ", подшагов на минуту: " << result.substeps
+             << ", записей: " << result.records << " (" << fixed << setprecision(1) << megabytes << " МБ)\n"
+             << "Время расчета: " << setprecision(3) << elapsed << " мс\n";
+        cout << "\nЧас | Запас газа, млн м3 | Мин. давление, МПа | Подача КС | Отбор (млн м3/сут)\n";
+        cout << string(80, '-') << endl;
+        for (const auto& s : result.hourly) {
+            if (s.minute % 180 != 0) continue;
+            cout << right << setw(3) << s.minute / 60 << " | " << setw(18) << setprecision(3) << s.linePack << " | ";
+            if (std::isinf(s.minPressure)) cout << setw(18) << "-";
+            else cout << setw(18) << s.minPressure;
+            cout << " | " << setw(9) << s.supply << " | " << setw(9) << s.withdrawal << left << endl;
         }
+        double packChange = result.hourly.back().linePack - result.hourly.front().linePack;
+        cout << "Изменение запаса газа за сутки: " << showpos << packChange << noshowpos << " млн м3\n";
         
-        // Проверка на циклы
-        if (result.size() != stations.size()) {
-            cout << "Обнаружен цикл в сети КС! Сортировка невозможна.\n";
-            
-            // Поиск циклических зависимостей
-            set<int> sortedStations(result.begin(), result.end());
-            cout << "КС, образующие циклы: ";
-            bool first = true;
-            for (const auto& station : stations) {
-                if (sortedStations.find(station.id) == sortedStations.end()) {
-                    if (!first) cout << ", ";
-                    cout << station.id << " (" << station.name << ")";
-                    first = false;
-                }
-            }
-            cout << endl;
+        logger.log("Нестационарный расчет",
+                  "Давление нагнетания: " + to_string(dischargePressure) + " МПа, Файл: " + filename +
+                  ", Записей: " + to_string(result.records));
+    }
+
+    // Проверка режима со многими источниками и потребителями: сколько газа
+    // доходит до потребителей и какая недопоставка у каждой КС
+    void checkSupplyDemand() {
+        vector<pair<int, double>> balances = stationBalances();
+        if (balances.empty()) {
+            cout << "Ни у одной КС не задан баланс (закачка или отбор)! Задайте его в редактировании КС.\n";
             return;
         }
         
-        // Вывод результата
-        cout << "\nТопологическая сортировка КС:\n";
-        for (size_t i = 0; i < result.size(); ++i) {
-            int stationIndex = findStationIndexById(result[i]);
-            if (stationIndex != -1) {
-                cout << (i + 1) << ". КС ID: " << result[i]
-                     << " (" << stations[stationIndex].name << ")\n";
+        bool limitStations = InputValidator::getIntInput("Учитывать производительность КС? (1 - да, 0 - нет): ", 0, 1) == 1;
+        const NetworkGraph& g = limitStations ? getSplitGraph() : getGraph();
+        
+        auto start = chrono::steady_clock::now();
+        SupplyDemandResult result = SupplyDemandSolver::solve(g, balances);
+        double elapsed = elapsedMs(start);
+        
+        cout << "\nКС с балансом: " << balances.size() << ", время расчета: "
+             << fixed << setprecision(3) << elapsed << " мс\n"
+             << "Закачка: " << setprecision(1) << result.totalSupply << " усл. ед., отбор: "
+             << result.totalDemand << " усл. ед., доставлено: " << result.delivered << " усл. ед.\n";
+        cout << (result.unmetDemand.empty() ? "Режим допустим: спрос всех потребителей покрыт.\n"
+                                            : "Режим недопустим: спрос покрыт не полностью.\n");
+        
+        const size_t shown = 20;
+        auto printShortfalls = [&](const string& title, const vector<StationShortfall>& items) {
+            if (items.empty()) return;
+            cout << "\n" << title << " (" << items.size() << "):\n";
+            for (size_t i = 0; i < items.size() && i < shown; ++i) {
+                const CompressorStation& station = stations[findStationIndexById(items[i].stationId)];
+                cout << "КС " << station.id << " (" << station.name << "): " << fixed << setprecision(1)
+                     << items[i].amount << " из " << fabs(station.balance) << " усл. ед.\n";
+            }
+            if (items.size() > shown) cout << "(показаны первые " << shown << ")\n";
+        };
+        printShortfalls("Недопоставка потребителям", result.unmetDemand);
+        printShortfalls("Невостребованная закачка источников", result.unusedSupply);
+        
+        logger.log("Проверка баланса поставок",
+                  "КС с балансом: " + to_string(balances.size()) +
+                  ", Доставлено: " + to_string(result.delivered) +
+                  ", Недопоставка: " + to_string(result.totalDemand - result.delivered));
+    }
+
+    // Трубы, соединяющие трубу с трубой (индекс - ID трубы)
+    vector<char> pipeToPipeFlags() const {
+        int limit = getGraph().pipeIdLimit();
+        vector<char> flags(limit, 0);
+        for (const auto& conn : network) {
+            if (conn.startType == PIPE_TO_PIPE && conn.pipeId >= 0 && conn.pipeId < limit) {
+                flags[conn.pipeId] = 1;
             }
         }
+        return flags;
     }
 
-    // Поиск кратчайшего пути между КС
-    void findShortestPath() {
+    // Многокритериальный поиск: все недоминируемые маршруты между КС по длине,
+    // пропускной способности самой слабой трубы и числу соединений труба-труба
+    void findParetoRoutes() {
         if (stations.size() < 2) {
             cout << "Для поиска пути нужно как минимум 2 КС!\n";
             return;
@@ -1119,69 +6451,60 @@ private:
         
         viewAll();
         
-        cout << "\nПоиск кратчайшего пути между КС:\n";
+        cout << "\nМногокритериальный поиск маршрутов между КС:\n";
         int startId = InputValidator::getIntInput("Введите ID начальной КС: ", 1);
         int endId = InputValidator::getIntInput("Введите ID конечной КС: ", 1);
         
-        // Проверка существования КС
-        int startIndex = findStationIndexById(startId);
-        int endIndex = findStationIndexById(endId);
-        
-        if (startIndex == -1) {
+        if (findStationIndexById(startId) == -1) {
             cout << "КС с ID " << startId << " не найдена!\n";
             return;
         }
-        
-        if (endIndex == -1) {
+        if (findStationIndexById(endId) == -1) {
             cout << "КС с ID " << endId << " не найдена!\n";
             return;
         }
         
-        // Поиск кратчайшего пути с помощью алгоритма Дейкстры
-        auto [distance, path] = dijkstraShortestPath(startId, endId);
+        const NetworkGraph& g = getGraph();
+        int startIndex = g.nodeIndex(startId);
+        int endIndex = g.nodeIndex(endId);
+        if (startIndex == -1 || endIndex == -1) {
+            cout << "Маршруты между КС " << startId << " и КС " << endId << " не найдены!\n";
+            return;
+        }
+        
+        auto startTime = chrono::steady_clock::now();
+        ParetoFront front = ShortestPathSolver(g).paretoRoutes(startIndex, endIndex, pipeToPipeFlags(),
+                                                               PARETO_LABEL_LIMIT);
+        double elapsed = elapsedMs(startTime);
+        cout << "Обработано меток: " << front.labels << ", время: " << fixed << setprecision(3) << elapsed << " мс\n";
         
-        if (distance < numeric_limits<double>::infinity()) {
-            cout << "\nКратчайший путь найден!\n";
-            cout << "Общее расстояние: " << fixed << setprecision(2) << distance << " км\n";
-            cout << "Путь: ";
-            
-            for (size_t i = 0; i < path.size(); ++i) {
-                auto [isStation, idx] = getObjectInfo(path[i]);
-                string type = isStation ? "КС" : "Труба";
-                string name = isStation ? stations[idx].name : pipes[idx].name;
-                
-                cout << type << " " << path[i] << " (" << name << ")";
-                if (i < path.size() - 1) {
-                    cout << " -> ";
-                }
-            }
-            cout << endl;
-            
-            // Детализация по трубам на пути
-            cout << "\nДетали пути:\n";
-            double totalLength = 0;
-            for (const auto& conn : network) {
-                if (find(path.begin(), path.end(), conn.startId) != path.end() &&
-                    find(path.begin(), path.end(), conn.endId) != path.end()) {
-                    int pipeIndex = findPipeIndexById(conn.pipeId);
-                    if (pipeIndex != -1) {
-                        const Pipe& pipe = pipes[pipeIndex];
-                        cout << "Труба ID: " << pipe.id << " (" << pipe.name << "), "
-                             << "Длина: " << pipe.length << " км, "
-                             << "Диаметр: " << pipe.diameter << " мм, "
-                             << "Вес: " << pipe.getWeight() << endl;
-                        totalLength += pipe.length;
-                    }
-                }
+        if (front.routes.empty()) {
+            cout << "Маршруты между КС " << startId << " и КС " << endId << " не найдены!\n";
+            return;
+        }
+        if (front.truncated) {
+            cout << "Внимание: наборы меток ограничены (" << PARETO_LABEL_LIMIT
+                 << " на вершину), фронт может быть неполным.\n";
+        }
+        
+        cout << "\nНедоминируемые маршруты (" << front.routes.size() << "):\n";
+        cout << "  № | Длина, км | Пропускная способность | Соединений труба-труба | Путь\n";
+        cout << string(90, '-') << endl;
+        for (size_t i = 0; i < front.routes.size(); ++i) {
+            const ParetoRoute& route = front.routes[i];
+            cout << right << setw(3) << i + 1 << " | " << setw(9) << fixed << setprecision(2) << route.length
+                 << " | " << setw(22) << route.width << " | " << setw(22) << route.joints << " | ";
+            for (size_t k = 0; k < route.nodes.size(); ++k) {
+                int id = g.nodeId(route.nodes[k]);
+                cout << (getObjectInfo(id).first ? "КС " : "Труба ") << id;
+                if (k < route.nodes.size() - 1) cout << " -> ";
             }
-            cout << "Суммарная длина труб на пути: " << totalLength << " км\n";
-        } else {
-            cout << "Путь между КС " << startId << " и КС " << endId << " не найден!\n";
+            cout << left << endl;
         }
         
-        logger.log("Поиск кратчайшего пути",
+        logger.log("Многокритериальный поиск маршрутов",
                   "От КС: " + to_string(startId) + " до КС: " + to_string(endId) +
-                  ", Расстояние: " + to_string(distance));
+                  ", Маршрутов: " + to_string(front.routes.size()));
     }
 
     // Расчет максимального потока между КС
@@ -1216,95 +6539,326 @@ private:
             return;
         }
         
-        // Расчет максимального потока с помощью алгоритма Эдмондса-Карпа
-        auto [maxFlow, flowMap] = edmondsKarpMaxFlow(sourceId, sinkId);
+        bool limitStations = InputValidator::getIntInput("Учитывать производительность КС? (1 - да, 0 - нет): ", 0, 1) == 1;
+        
+        bool incremental = false;
+        if (hasPreviousMaxFlow(sourceId, sinkId, limitStations)) {
+            incremental = InputValidator::getIntInput(
+                "Найден предыдущий расчет для этих КС. Пересчитать от него? (1 - да, 0 - нет): ", 0, 1) == 1;
+        }
+        MaxFlowAlgorithm algorithm = incremental ? DINIC : selectMaxFlowAlgorithm();
+        bool withPaths = InputValidator::getIntInput("Разложить поток на пути? (1 - да, 0 - нет): ", 0, 1) == 1;
+        
+        auto start = chrono::steady_clock::now();
+        MaxFlowResult result = incremental ?
+            recomputeMaxFlow(sourceId, sinkId, withPaths, limitStations) :
+            computeMaxFlow(sourceId, sinkId, algorithm, withPaths, limitStations);
+        double elapsed = elapsedMs(start);
+        double maxFlow = result.value;
+        
+        auto pipeFlow = [&result](int pipeId) {
+            return pipeId < static_cast<int>(result.pipeFlow.size()) ? result.pipeFlow[pipeId] : 0.0;
+        };
         
         cout << "\nРезультаты расчета максимального потока:\n";
         cout << "Максимальный поток от КС " << sourceId << " до КС " << sinkId
              << ": " << fixed << setprecision(1) << maxFlow << " усл. ед.\n";
+        cout << "Время расчета: " << fixed << setprecision(3) << elapsed << " мс\n";
+        
+        if (maxFlow > 0) {
+            cout << "\nРаспределение потока по трубам:\n";
+            cout << "Начало -> Конец | Труба | Пропускная способность | Текущий поток | Загрузка\n";
+            cout << string(80, '-') << endl;
+            
+            for (const auto& conn : network) {
+                int pipeIndex = findPipeIndexById(conn.pipeId);
+                if (pipeIndex == -1) continue;
+                
+                double capacity = pipes[pipeIndex].getCapacity();
+                if (capacity <= 0) continue;
+                double flow = pipeFlow(conn.pipeId);
+                double utilization = flow / capacity * 100;
+                
+                cout << setw(5) << conn.startId << " -> " << setw(7) << conn.endId << " | "
+                     << setw(5) << conn.pipeId << " | "
+                     << setw(21) << fixed << setprecision(1) << capacity << " | "
+                     << setw(14) << fixed << setprecision(1) << flow << " | "
+                     << setw(7) << fixed << setprecision(1) << utilization << "%" << endl;
+            }
+            
+            if (withPaths) {
+                cout << "\nРазложение потока на пути (" << result.paths.size() << "):\n";
+                for (size_t i = 0; i < result.paths.size(); ++i) {
+                    const FlowPath& path = result.paths[i];
+                    cout << (i + 1) << ". " << fixed << setprecision(2) << path.amount << " усл. ед.: ";
+                    for (size_t j = 0; j < path.nodeIds.size(); ++j) {
+                        if (j > 0) cout << " -(Тр" << path.pipeIds[j - 1] << ")-> ";
+                        cout << path.nodeIds[j];
+                    }
+                    cout << endl;
+                }
+            }
+            
+            // Узкие места - трубы минимального разреза
+            const NetworkGraph& g = limitStations ? getSplitGraph() : getGraph();
+            MinCutResult cut = MaxFlowSolver::minCut(g, g.nodeIndex(sourceId), result.arcFlow);
+            
+            cout << "\nМинимальный разрез (узкие места сети):\n";
+            cout << "Суммарная пропускная способность разреза: " << fixed << setprecision(2)
+                 << cut.capacity << " усл. ед.\n";
+            cout << "Труба | Начало -> Конец | Пропускная способность\n";
+            cout << string(50, '-') << endl;
+            for (int pipeId : cut.pipeIds) {
+                const Pipe& pipe = pipes[findPipeIndexById(pipeId)];
+                cout << setw(5) << pipeId << " | "
+                     << setw(5) << pipe.startId << " -> " << setw(7) << pipe.endId << " | "
+                     << setw(10) << fixed << setprecision(2) << pipe.getCapacity() << endl;
+            }
+            for (int stationId : cut.stationIds) {
+                const CompressorStation& station = stations[findStationIndexById(stationId)];
+                cout << "КС " << stationId << " (" << station.name << "): производительность "
+                     << fixed << setprecision(2) << station.getCapacity() << endl;
+            }
+            
+            auto printStations = [this](const string& title, const vector<int>& ids) {
+                cout << title;
+                bool first = true;
+                for (int id : ids) {
+                    if (findStationIndexById(id) == -1) continue;
+                    cout << (first ? "" : ", ") << id;
+                    first = false;
+                }
+                cout << (first ? "нет" : "") << endl;
+            };
+            printStations("КС на стороне источника: ", cut.sourceSideIds);
+            printStations("КС на стороне стока: ", cut.sinkSideIds);
+        } else {
+            cout << "Невозможно найти путь для потока между указанными КС!\n";
+        }
+        
+        logger.log("Расчет максимального потока",
+                  "От КС: " + to_string(sourceId) + " до КС: " + to_string(sinkId) +
+                  ", Макс. поток: " + to_string(maxFlow));
+    }
+
+    // Матрица кратчайших расстояний между выбранными КС (на экран или в двоичный файл)
+    void calculateDistanceMatrix() {
+        if (stations.empty()) {
+            cout << "Нет доступных КС!\n";
+            return;
+        }
+        
+        vector<int> stationIds = getStationIds();
+        cout << "\nНачальные КС:";
+        vector<int> sourceIndices = selectMultipleObjects(stationIds, "КС");
+        cout << "Конечные КС:";
+        vector<int> targetIndices = selectMultipleObjects(stationIds, "КС");
+        if (sourceIndices.empty() || targetIndices.empty()) {
+            cout << "КС не выбраны!\n";
+            return;
+        }
+        
+        vector<int> sourceIds, targetIds;
+        for (int index : sourceIndices) sourceIds.push_back(stationIds[index]);
+        for (int index : targetIndices) targetIds.push_back(stationIds[index]);
+        
+        cout << "1. Вывести на экран\n2. Сохранить в двоичный файл\n";
+        int choice = InputValidator::getIntInput("Выберите действие: ", 1, 2);
+        
+        if (choice == 1) {
+            auto start = chrono::steady_clock::now();
+            DistanceMatrix matrix = distanceMatrix(sourceIds, targetIds);
+            double elapsed = elapsedMs(start);
+            
+            cout << "\nРасстояния, км (\"-\" - пути нет):\n" << right << "   От\\До";
+            for (int id : targetIds) cout << setw(10) << id;
+            cout << endl;
+            for (size_t i = 0; i < sourceIds.size(); ++i) {
+                cout << setw(8) << sourceIds[i];
+                for (size_t j = 0; j < targetIds.size(); ++j) {
+                    double value = matrix.values[i * targetIds.size() + j];
+                    if (value < ShortestPathSolver::INF) {
+                        cout << setw(10) << fixed << setprecision(2) << value;
+                    } else {
+                        cout << setw(10) << "-";
+                    }
+                }
+                cout << endl;
+            }
+            cout << left << "Время расчета: " << fixed << setprecision(3) << elapsed << " мс\n";
+        } else {
+            string filename = InputValidator::getStringInput("Введите имя файла: ");
+            if (filename.find('.') == string::npos) {
+                filename += ".bin";
+            }
+            
+            auto start = chrono::steady_clock::now();
+            if (!writeDistanceMatrix(sourceIds, targetIds, filename)) {
+                cout << "Ошибка: невозможно записать файл " << filename << endl;
+                return;
+            }
+            cout << "Матрица " << sourceIds.size() << " x " << targetIds.size() << " сохранена в файл "
+                 << filename << " за " << fixed << setprecision(3) << elapsedMs(start) << " мс\n";
+        }
+        
+        logger.log("Матрица расстояний",
+                  "Начальных КС: " + to_string(sourceIds.size()) + ", конечных КС: " + to_string(targetIds.size()));
+    }
+
+    // Время в миллисекундах, прошедшее с момента start
+    static double elapsedMs(chrono::steady_clock::time_point start) {
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    }
+
+    // Сгенерированная сеть для тестов производительности
+    struct SyntheticNetwork {
+        vector<Pipe> pipes;
+        vector<CompressorStation> stations;
+        vector<NetworkConnection> network;
+    };
+
+    // Генерация сети-решетки side x side КС: соединения вправо и вниз (к стоку),
+    // часть соединений дублируется в обратную сторону, плюс случайные хорды.
+    // chordSpan > 0 - хорды только между КС не дальше chordSpan строк и столбцов
+    // (сеть остается почти планарной, как реальная трубопроводная)
+    static SyntheticNetwork generateSyntheticNetwork(int side, unsigned seed, int chordSpan = 0) {
+        SyntheticNetwork net;
+        mt19937 rng(seed);
+        uniform_int_distribution<int> diameterPick(0, PIPE_CAPACITIES.size() - 1);
+        uniform_real_distribution<double> lengthPick(5.0, 100.0);
+        uniform_real_distribution<double> chance(0.0, 1.0);
+        uniform_int_distribution<int> workshopsPick(1, 10);
+        uniform_int_distribution<int> classPick(1, 3);
+        
+        int count = side * side;
+        for (int i = 0; i < count; ++i) {
+            CompressorStation station;
+            station.id = i + 1;
+            station.name = "КС" + to_string(i + 1);
+            station.totalWorkshops = workshopsPick(rng);
+            station.activeWorkshops = uniform_int_distribution<int>(0, station.totalWorkshops)(rng);
+            station.stationClass = classPick(rng);
+            net.stations.push_back(station);
+        }
         
-        if (maxFlow > 0) {
-            cout << "\nРаспределение потока по трубам:\n";
-            cout << "Начало -> Конец | Труба | Пропускная способность | Текущий поток | Загрузка\n";
-            cout << string(80, '-') << endl;
-            
-            for (const auto& [edge, flow] : flowMap) {
-                auto [u, v] = edge;
-                // Находим трубу между этими узлами
-                int pipeId = -1;
-                for (const auto& conn : network) {
-                    if (conn.startId == u && conn.endId == v) {
-                        pipeId = conn.pipeId;
-                        break;
-                    }
+        auto connect = [&](int from, int to) {
+            Pipe pipe;
+            pipe.id = net.pipes.size() + 1;
+            pipe.name = "Тр" + to_string(pipe.id);
+            pipe.length = lengthPick(rng);
+            pipe.diameter = PIPE_CAPACITIES[diameterPick(rng)].diameter;
+            pipe.underRepair = false;
+            pipe.inUse = true;
+            pipe.startId = from;
+            pipe.endId = to;
+            pipe.startType = STATION_TO_STATION;
+            pipe.endType = STATION_TO_STATION;
+            net.pipes.push_back(pipe);
+            net.network.push_back({pipe.id, from, to, STATION_TO_STATION, STATION_TO_STATION});
+        };
+        
+        for (int r = 0; r < side; ++r) {
+            for (int c = 0; c < side; ++c) {
+                int id = r * side + c + 1;
+                if (c + 1 < side) {
+                    connect(id, id + 1);
+                    if (chance(rng) < 0.3) connect(id + 1, id);
                 }
-                
-                if (pipeId != -1) {
-                    int pipeIndex = findPipeIndexById(pipeId);
-                    if (pipeIndex != -1) {
-                        const Pipe& pipe = pipes[pipeIndex];
-                        double capacity = pipe.getCapacity();
-                        double utilization = (capacity > 0) ? (flow / capacity * 100) : 0;
-                        
-                        cout << setw(5) << u << " -> " << setw(7) << v << " | "
-                             << setw(5) << pipeId << " | "
-                             << setw(21) << fixed << setprecision(1) << capacity << " | "
-                             << setw(14) << fixed << setprecision(1) << flow << " | "
-                             << setw(7) << fixed << setprecision(1) << utilization << "%" << endl;
-                    }
+                if (r + 1 < side) {
+                    connect(id, id + side);
+                    if (chance(rng) < 0.3) connect(id + side, id);
                 }
             }
+        }
+        uniform_int_distribution<int> nodePick(1, count);
+        uniform_int_distribution<int> shiftPick(-chordSpan, chordSpan);
+        for (int i = 0; i < count / 10; ++i) {
+            int from = nodePick(rng);
+            int to;
+            if (chordSpan > 0) {
+                int r = min(side - 1, max(0, (from - 1) / side + shiftPick(rng)));
+                int c = min(side - 1, max(0, (from - 1) % side + shiftPick(rng)));
+                to = r * side + c + 1;
+            } else {
+                to = nodePick(rng);
+            }
+            if (from != to) connect(from, to);
+        }
+        return net;
+    }
+
+    // Обмен текущих данных системы со сгенерированной сетью (и обратно)
+    void swapNetworkState(SyntheticNetwork& other) {
+        pipes.swap(other.pipes);
+        stations.swap(other.stations);
+        network.swap(other.network);
+        pipeIdIndex.clear();
+        pipeIdIndex.rebuild(pipes);
+        stationIdIndex.clear();
+        stationIdIndex.rebuild(stations);
+        markNetworkChanged();
+    }
+
+    // Бенчмарк поиска по ID: индекс IdIndex против линейного поиска find_if
+    void benchmarkIdLookup() const {
+        struct Item { int id; };
+        const int queries = 1000000;
+        mt19937 rng(42);
+        
+        cout << "\nПоиск объекта по ID (" << queries << " случайных запросов)\n";
+        cout << "Объектов | IdIndex, нс/запрос | find_if, нс/запрос\n";
+        cout << string(60, '-') << endl;
+        
+        for (int count : {1000, 10000, 100000, 1000000, 10000000}) {
+            vector<Item> items(count);
+            for (int i = 0; i < count; ++i) items[i].id = i + 1;
+            IdIndex index;
+            index.rebuild(items);
             
-            // Анализ узких мест
-            cout << "\nАнализ узких мест (минимальные остаточные пропускные способности):\n";
-            vector<pair<double, pair<int, int>>> bottlenecks;
+            uniform_int_distribution<int> pick(1, count);
+            vector<int> ids(queries);
+            for (int& id : ids) id = pick(rng);
             
-            for (const auto& [edge, flow] : flowMap) {
-                auto [u, v] = edge;
-                int pipeId = -1;
-                for (const auto& conn : network) {
-                    if (conn.startId == u && conn.endId == v) {
-                        pipeId = conn.pipeId;
-                        break;
-                    }
-                }
-                
-                if (pipeId != -1) {
-                    int pipeIndex = findPipeIndexById(pipeId);
-                    if (pipeIndex != -1) {
-                        const Pipe& pipe = pipes[pipeIndex];
-                        double capacity = pipe.getCapacity();
-                        double residual = capacity - flow;
-                        
-                        if (residual < 1.0 && capacity > 0) {
-                            bottlenecks.push_back({residual, {u, v}});
-                        }
-                    }
-                }
-            }
+            long long checksum = 0;
+            auto start = chrono::steady_clock::now();
+            for (int id : ids) checksum += index.find(id);
+            double indexNs = elapsedMs(start) * 1e6 / queries;
             
-            if (!bottlenecks.empty()) {
-                sort(bottlenecks.begin(), bottlenecks.end());
-                cout << "Наиболее узкие места (по остаточной пропускной способности):\n";
-                for (const auto& [residual, edge] : bottlenecks) {
-                    auto [u, v] = edge;
-                    cout << "Между " << u << " и " << v << ": остаточная пропускная способность = "
-                         << fixed << setprecision(2) << residual << endl;
+            // Линейный поиск слишком медленный на больших объемах, берем меньше запросов
+            string linearStr = "-";
+            if (count <= 100000) {
+                int linearQueries = max(100, 10000000 / count);
+                start = chrono::steady_clock::now();
+                for (int q = 0; q < linearQueries; ++q) {
+                    int id = ids[q];
+                    auto it = find_if(items.begin(), items.end(), [id](const Item& item) { return item.id == id; });
+                    checksum += distance(items.begin(), it);
                 }
+                stringstream ss;
+                ss << fixed << setprecision(1) << elapsedMs(start) * 1e6 / linearQueries;
+                linearStr = ss.str();
             }
-        } else {
-            cout << "Невозможно найти путь для потока между указанными КС!\n";
+            
+            cout << setw(8) << count << " | " << setw(18) << fixed << setprecision(1) << indexNs
+                 << " | " << setw(18) << linearStr << (checksum == 0 ? " " : "") << endl;
         }
-        
-        logger.log("Расчет максимального потока",
-                  "От КС: " + to_string(sourceId) + " до КС: " + to_string(sinkId) +
-                  ", Макс. поток: " + to_string(maxFlow));
+    }
+
+    // Следующий ID из счетчика. ID от DENSE_LIMIT не выдаются: индекс
+    // их не хранит, и объект нельзя было бы найти по ID
+    bool issueId(int& counter, int& id) {
+        if (counter >= IdIndex::DENSE_LIMIT) {
+            cout << "Ошибка: исчерпан диапазон ID (не более " << IdIndex::DENSE_LIMIT - 1 << ").\n";
+            return false;
+        }
+        id = counter++;
+        return true;
     }
 
 public:
     void addPipe() {
         Pipe newPipe;
-        newPipe.id = nextPipeId++;
+        if (!issueId(nextPipeId, newPipe.id)) return;
         newPipe.name = InputValidator::getStringInput("Введите название трубы: ");
         newPipe.length = InputValidator::getDoubleInput("Введите длину трубы (км): ", 0.001);
         newPipe.diameter = InputValidator::getDiameterInput("Введите диаметр трубы");
@@ -1316,13 +6870,14 @@ public:
         newPipe.endType = STATION_TO_STATION;
         
         pipes.push_back(newPipe);
+        pipeIdIndex.set(newPipe.id, pipes.size() - 1);
         cout << "Труба '" << newPipe.name << "' добавлена с ID: " << newPipe.id << "!\n";
         logger.log("Добавлена труба", "ID: " + to_string(newPipe.id) + ", Название: " + newPipe.name);
     }
 
     void addStation() {
         CompressorStation newStation;
-        newStation.id = nextStationId++;
+        if (!issueId(nextStationId, newStation.id)) return;
         newStation.name = InputValidator::getStringInput("Введите название КС: ");
         newStation.totalWorkshops = InputValidator::getIntInput("Введите количество цехов: ", 1);
         newStation.activeWorkshops = InputValidator::getIntInput("Введите работающих цехов: ",
@@ -1330,6 +6885,7 @@ public:
         newStation.stationClass = InputValidator::getIntInput("Введите класс станции: ", 1);
         
         stations.push_back(newStation);
+        stationIdIndex.set(newStation.id, stations.size() - 1);
         cout << "КС '" << newStation.name << "' добавлена с ID: " << newStation.id << "!\n";
         logger.log("Добавлена КС", "ID: " + to_string(newStation.id) + ", Название: " + newStation.name);
     }
@@ -1371,10 +6927,17 @@ public:
             if (isPipe) {
                 cout << "Удалена труба: " << pipes[index].name << " (ID: " << pipes[index].id << ")\n";
                 logger.log("Удалена труба", "ID: " + to_string(pipes[index].id) + ", Название: " + pipes[index].name);
+                pipeIdIndex.erase(pipes[index].id);
                 pipes.erase(pipes.begin() + index);
+                pipeIdIndex.rebuild(pipes, index);
             } else {
                 // При удалении станции удаляем все соединения с ней
                 int stationId = stations[index].id;
+                for (const auto& conn : network) {
+                    if (conn.startId == stationId || conn.endId == stationId) {
+                        applyNetworkDelta(makePipeDelta(ARC_REMOVED, conn.pipeId));
+                    }
+                }
                 auto it = remove_if(network.begin(), network.end(),
                                    [stationId](const NetworkConnection& conn) {
                                        return conn.startId == stationId || conn.endId == stationId;
@@ -1392,7 +6955,9 @@ public:
                 
                 cout << "Удалена КС: " << stations[index].name << " (ID: " << stations[index].id << ")\n";
                 logger.log("Удалена КС", "ID: " + to_string(stations[index].id) + ", Название: " + stations[index].name);
+                stationIdIndex.erase(stations[index].id);
                 stations.erase(stations.begin() + index);
+                stationIdIndex.rebuild(stations, index);
             }
             count++;
         }
@@ -1421,6 +6986,7 @@ public:
         
         if (choice == 1) {
             pipes[index].underRepair = !pipes[index].underRepair;
+            applyNetworkDelta(makePipeDelta(ARC_UPDATED, pipes[index].id));
             string status = pipes[index].underRepair ? "В ремонте" : "Работает";
             cout << "Статус ремонта изменен на: " << status << endl;
             
@@ -1440,6 +7006,7 @@ public:
             } else {
                 cout << "Диаметр нельзя изменить, так как труба используется в сети.\n";
             }
+            applyNetworkDelta(makePipeDelta(ARC_UPDATED, pipes[index].id));
             
             cout << "Параметры трубы обновлены!\n";
             logger.log("Обновлена труба", "ID: " + to_string(pipes[index].id) + ", Новое название: " + pipes[index].name);
@@ -1462,8 +7029,9 @@ public:
         }
         
         cout << "Редактирование КС ID: " << stations[index].id << " - " << stations[index].name << endl;
-        cout << "1. Запустить/остановить цех\n2. Редактировать параметры\n";
-        int choice = InputValidator::getIntInput("Выберите действие: ", 1, 2);
+        cout << "1. Запустить/остановить цех\n2. Редактировать параметры\n"
+             << "3. Задать закачку/отбор газа (баланс)\n";
+        int choice = InputValidator::getIntInput("Выберите действие: ", 1, 3);
         
         if (choice == 1) {
             cout << "Текущее состояние: " << stations[index].activeWorkshops
@@ -1473,15 +7041,26 @@ public:
             
             if (action == 1 && stations[index].activeWorkshops < stations[index].totalWorkshops) {
                 stations[index].activeWorkshops++;
+                markStationsChanged(index);
                 cout << "Цех запущен! Работает цехов: " << stations[index].activeWorkshops << endl;
                 logger.log("Запущен цех КС", "ID: " + to_string(stations[index].id) + ", Работает цехов: " + to_string(stations[index].activeWorkshops));
             } else if (action == 2 && stations[index].activeWorkshops > 0) {
                 stations[index].activeWorkshops--;
+                markStationsChanged(index);
                 cout << "Цех остановлен! Работает цехов: " << stations[index].activeWorkshops << endl;
                 logger.log("Остановлен цех КС", "ID: " + to_string(stations[index].id) + ", Работает цехов: " + to_string(stations[index].activeWorkshops));
             } else {
                 cout << "Невозможно выполнить операцию!\n";
             }
+        } else if (choice == 3) {
+            cout << "Текущий баланс: " << fixed << setprecision(1) << stations[index].balance << " усл. ед.\n";
+            stations[index].balance = InputValidator::getDoubleInput(
+                "Введите баланс (> 0 - закачка, < 0 - отбор, 0 - нет): ",
+                -numeric_limits<double>::max());
+            
+            cout << "Баланс КС обновлен!\n";
+            logger.log("Изменен баланс КС", "ID: " + to_string(stations[index].id) +
+                      ", Баланс: " + to_string(stations[index].balance));
         } else {
             stations[index].name = InputValidator::getStringInput("Введите новое название КС: ");
             int newTotal = InputValidator::getIntInput("Введите новое количество цехов: ", 1);
@@ -1491,6 +7070,7 @@ public:
             }
             stations[index].totalWorkshops = newTotal;
             stations[index].stationClass = InputValidator::getIntInput("Введите новый класс станции: ", 1);
+            markStationsChanged(index);
             
             cout << "Параметры КС обновлены!\n";
             logger.log("Обновлена КС", "ID: " + to_string(stations[index].id) + ", Новое название: " + stations[index].name);
@@ -1615,6 +7195,16 @@ public:
                  << conn.startType << endl << conn.endType << endl;
         }
         
+        // Необязательный раздел: балансы КС (только ненулевые, ID и баланс)
+        size_t balanceCount = count_if(stations.begin(), stations.end(),
+                                       [](const CompressorStation& station) { return station.balance != 0; });
+        if (balanceCount > 0) {
+            file << "STATION_BALANCES " << balanceCount << endl;
+            for (const auto& station : stations) {
+                if (station.balance != 0) file << station.id << " " << station.balance << endl;
+            }
+        }
+        
         file.close();
         cout << "Данные сохранены в файл: " << fs::absolute(filename) << endl;
         logger.log("Сохранение данных", "Файл: " + filename +
@@ -1635,6 +7225,9 @@ public:
         pipes.clear();
         stations.clear();
         network.clear();
+        pipeIdIndex.clear();
+        stationIdIndex.clear();
+        markNetworkChanged();
         
         string header;
         size_t count;
@@ -1648,6 +7241,14 @@ public:
             file >> header >> nextStationId;
         }
         
+        // Граф и расчеты держат плотные массивы по ID труб, поэтому ID из файла
+        // ограничены, как и счетчики новых ID
+        auto validId = [](long long id) { return id >= 1 && id < IdIndex::DENSE_LIMIT; };
+        if (!file || !validId(nextPipeId) || !validId(nextStationId)) {
+            cout << "Ошибка: неверный формат файла.\n";
+            return;
+        }
+        
         file >> header >> count;
         if (header != "PIPES") {
             cout << "Ошибка: неверный формат файла.\n";
@@ -1664,7 +7265,12 @@ public:
                  >> pipe.inUse >> pipe.startId >> pipe.endId
                  >> pipe.startType >> pipe.endType;
             file.ignore();
+            if (!validId(pipe.id)) {
+                cout << "Ошибка: недопустимый ID трубы " << pipe.id << " в файле.\n";
+                return;
+            }
             pipes.push_back(pipe);
+            pipeIdIndex.set(pipe.id, pipes.size() - 1);
         }
         
         file >> header >> count;
@@ -1685,12 +7291,17 @@ public:
             if (station.activeWorkshops > station.totalWorkshops) {
                 station.activeWorkshops = station.totalWorkshops;
             }
+            if (!validId(station.id)) {
+                cout << "Ошибка: недопустимый ID КС " << station.id << " в файле.\n";
+                return;
+            }
             
             stations.push_back(station);
+            stationIdIndex.set(station.id, stations.size() - 1);
         }
         
-        // Загрузка сети (если есть)
-        if (file >> header >> count) {
+        // Загрузка сети и балансов КС (если есть)
+        while (file >> header >> count) {
             if (header == "NETWORK") {
                 file.ignore();
                 for (size_t i = 0; i < count; ++i) {
@@ -1700,6 +7311,16 @@ public:
                     file.ignore();
                     network.push_back(conn);
                 }
+            } else if (header == "STATION_BALANCES") {
+                for (size_t i = 0; i < count; ++i) {
+                    int id;
+                    double balance;
+                    file >> id >> balance;
+                    int index = findStationIndexById(id);
+                    if (index != -1) stations[index].balance = balance;
+                }
+            } else {
+                break;
             }
         }
         
@@ -1713,6 +7334,918 @@ public:
                   ", Соединения: " + to_string(network.size()));
     }
 
+    // Бенчмарк алгоритмов максимального потока на сгенерированных сетях
+    void benchmarkMaxFlow() {
+        cout << "\nМаксимальный поток между углами сети-решетки, мс\n";
+        // Базовая линия - Эдмондс-Карп на том же CSR-графе
+        cout << "   КС |  Труб | Эдмондс-Карп |    Диниц | Предпоток | Поток\n";
+        cout << string(64, '-') << endl;
+        
+        for (int side : {10, 30, 60, 100, 200}) {
+            SyntheticNetwork net = generateSyntheticNetwork(side, 7);
+            swapNetworkState(net);
+            
+            int sourceId = 1;
+            int sinkId = side * side;
+            getGraph();
+            
+            double times[3];
+            double values[3];
+            MaxFlowAlgorithm algorithms[3] = {EDMONDS_KARP, DINIC, PUSH_RELABEL};
+            for (int i = 0; i < 3; ++i) {
+                auto start = chrono::steady_clock::now();
+                values[i] = computeMaxFlow(sourceId, sinkId, algorithms[i]).value;
+                times[i] = elapsedMs(start);
+            }
+            
+            bool agree = fabs(values[0] - values[1]) < 1e-6 && fabs(values[0] - values[2]) < 1e-6;
+            cout << setw(5) << side * side << " | " << setw(6) << pipes.size() << " | "
+                 << setw(12) << fixed << setprecision(2) << times[0] << " | "
+                 << setw(8) << times[1] << " | "
+                 << setw(9) << times[2] << " | "
+                 << setprecision(3) << values[1] << (agree ? "" : " (расхождение!)") << endl;
+            
+            swapNetworkState(net);
+        }
+    }
+
+    // Бенчмарк инкрементального пересчета потока после одиночных изменений труб
+    void benchmarkIncrementalMaxFlow() {
+        const int edits = 40;
+        cout << "\nПересчет максимального потока после одного изменения трубы (" << edits << " изменений), мс\n";
+        cout << "   КС |  Труб | С нуля (Диниц) | Инкрементально | Совпадение\n";
+        cout << string(70, '-') << endl;
+        
+        for (int side : {30, 60, 100, 200}) {
+            SyntheticNetwork net = generateSyntheticNetwork(side, 11);
+            swapNetworkState(net);
+            
+            int sourceId = 1;
+            int sinkId = side * side;
+            computeMaxFlow(sourceId, sinkId, DINIC);
+            
+            mt19937 rng(side);
+            double coldTotal = 0, warmTotal = 0;
+            bool agree = true;
+            for (int i = 0; i < edits; ++i) {
+                // Половина изменений - трубы с потоком, остальные - случайные
+                const MaxFlowResult& previous = maxFlowCache[{sourceId, sinkId, false}].result;
+                int pipeIndex = uniform_int_distribution<int>(0, pipes.size() - 1)(rng);
+                if (i % 2 == 0) {
+                    for (size_t k = 0; k < pipes.size(); ++k) {
+                        int candidate = (pipeIndex + k) % pipes.size();
+                        int id = pipes[candidate].id;
+                        if (id < static_cast<int>(previous.pipeFlow.size()) && previous.pipeFlow[id] > 1e-9) {
+                            pipeIndex = candidate;
+                            break;
+                        }
+                    }
+                }
+                pipes[pipeIndex].underRepair = !pipes[pipeIndex].underRepair;
+                applyNetworkDelta(makePipeDelta(ARC_UPDATED, pipes[pipeIndex].id));
+                getGraph();
+                
+                auto start = chrono::steady_clock::now();
+                double warmValue = recomputeMaxFlow(sourceId, sinkId).value;
+                warmTotal += elapsedMs(start);
+                
+                const NetworkGraph& g = getGraph();
+                start = chrono::steady_clock::now();
+                double coldValue = MaxFlowSolver(g, g.nodeIndex(sourceId), g.nodeIndex(sinkId)).run(DINIC).value;
+                coldTotal += elapsedMs(start);
+                
+                agree = agree && fabs(warmValue - coldValue) < 1e-6;
+            }
+            
+            cout << setw(5) << side * side << " | " << setw(6) << pipes.size() << " | "
+                 << setw(14) << fixed << setprecision(3) << coldTotal / edits << " | "
+                 << setw(14) << warmTotal / edits << " | "
+                 << (agree ? "да" : "НЕТ") << endl;
+            
+            swapNetworkState(net);
+        }
+        maxFlowCache.clear();
+    }
+
+    // Бенчмарк алгоритмов кратчайшего пути: время и число обработанных вершин
+    void benchmarkShortestPath() {
+        const int queries = 200;
+        cout << "\nКратчайший путь между случайными КС (" << queries << " запросов), среднее на запрос\n";
+        cout << "   КС | Дейкстра: мс / вершин | Двунаправленный: мс / вершин |   ALT: мс / вершин\n";
+        cout << string(90, '-') << endl;
+        
+        for (int side : {30, 100, 200, 300}) {
+            SyntheticNetwork net = generateSyntheticNetwork(side, 13);
+            swapNetworkState(net);
+            getLandmarks();
+            
+            mt19937 rng(side);
+            uniform_int_distribution<int> pick(1, side * side);
+            vector<pair<int, int>> pairs(queries);
+            for (auto& pr : pairs) pr = {pick(rng), pick(rng)};
+            
+            ShortestPathAlgorithm algorithms[3] = {DIJKSTRA, BIDIRECTIONAL_DIJKSTRA, ALT_ASTAR};
+            double times[3] = {0, 0, 0};
+            long long settled[3] = {0, 0, 0};
+            for (int i = 0; i < 3; ++i) {
+                auto start = chrono::steady_clock::now();
+                for (const auto& [from, to] : pairs) {
+                    settled[i] += findRoute(from, to, algorithms[i]).settled;
+                }
+                times[i] = elapsedMs(start);
+            }
+            
+            cout << setw(5) << side * side;
+            for (int i = 0; i < 3; ++i) {
+                cout << " | " << setw(10) << fixed << setprecision(3) << times[i] / queries
+                     << " / " << setw(8) << settled[i] / queries;
+            }
+            cout << endl;
+            
+            swapNetworkState(net);
+        }
+    }
+
+    // Бенчмарк иерархии сжатия: подготовка и запросы против Дейкстры
+    void benchmarkContractionHierarchy() {
+        const int queries = 1000;
+        cout << "\nИерархия сжатия на почти планарной сети (" << queries << " запросов)\n";
+        cout << "   КС | Подготовка, мс | Сокращений | CH: мкс / вершин | Двунаправленный: мкс | Дейкстра: мкс\n";
+        cout << string(100, '-') << endl;
+        
+        for (int side : {30, 100, 200, 300}) {
+            SyntheticNetwork net = generateSyntheticNetwork(side, 13, 3);
+            swapNetworkState(net);
+            auto start = chrono::steady_clock::now();
+            const ContractionHierarchy& hierarchy = getContractionHierarchy();
+            double prepareTime = elapsedMs(start);
+            
+            mt19937 rng(side);
+            uniform_int_distribution<int> pick(1, side * side);
+            vector<pair<int, int>> pairs(queries);
+            for (auto& pr : pairs) pr = {pick(rng), pick(rng)};
+            
+            // Дейкстра и двунаправленный поиск - на части запросов, иначе тест слишком долгий
+            const int slowQueries = 50;
+            ShortestPathAlgorithm algorithms[3] = {CONTRACTION_HIERARCHY, BIDIRECTIONAL_DIJKSTRA, DIJKSTRA};
+            double perQuery[3];
+            long long settled = 0;
+            for (int i = 0; i < 3; ++i) {
+                int count = i == 0 ? queries : slowQueries;
+                start = chrono::steady_clock::now();
+                for (int q = 0; q < count; ++q) {
+                    int found = findRoute(pairs[q].first, pairs[q].second, algorithms[i]).settled;
+                    if (i == 0) settled += found;
+                }
+                perQuery[i] = elapsedMs(start) * 1000.0 / count;
+            }
+            
+            cout << setw(5) << side * side << " | " << setw(14) << fixed << setprecision(1) << prepareTime
+                 << " | " << setw(10) << hierarchy.shortcutCount()
+                 << " | " << setw(8) << setprecision(2) << perQuery[0] << " / " << setw(5) << settled / queries
+                 << " | " << setw(20) << perQuery[1] << " | " << setw(13) << perQuery[2] << endl;
+            
+            swapNetworkState(net);
+        }
+    }
+
+    // Бенчмарк настраиваемой иерархии: подготовка, перенастройка после ремонта
+    // трубы и запросы в сравнении с полной перестройкой CH
+    void benchmarkCustomizableHierarchy() {
+        const int queries = 1000;
+        const int toggles = 50;
+        cout << "\nНастраиваемая иерархия сжатия (" << toggles << " переключений ремонта, "
+             << queries << " запросов)\n";
+        cout << "   КС | Подготовка, мс | Настройка, мс | Ремонт: CCH, мс | Ремонт: CH, мс | CCH: мкс | CH: мкс"
+             << " | Совпадение\n";
+        cout << string(113, '-') << endl;
+        
+        for (int side : {30, 100, 200, 300}) {
+            SyntheticNetwork net = generateSyntheticNetwork(side, 13, 3);
+            swapNetworkState(net);
+            auto start = chrono::steady_clock::now();
+            getCustomizableHierarchy();
+            double prepareTime = elapsedMs(start);
+            start = chrono::steady_clock::now();
+            customizableHierarchy.customize();
+            double customizeTime = elapsedMs(start);
+            
+            // Переключение ремонта так же, как в editPipe; CCH обновляется в applyNetworkDelta
+            mt19937 rng(side);
+            uniform_int_distribution<int> pipePick(0, pipes.size() - 1);
+            start = chrono::steady_clock::now();
+            for (int i = 0; i < toggles; ++i) {
+                Pipe& pipe = pipes[pipePick(rng)];
+                pipe.underRepair = !pipe.underRepair;
+                applyNetworkDelta(makePipeDelta(ARC_UPDATED, pipe.id));
+            }
+            getCustomizableHierarchy();
+            double toggleTime = elapsedMs(start) / toggles;
+            
+            // CH после ремонта строится заново
+            start = chrono::steady_clock::now();
+            getContractionHierarchy();
+            double rebuildTime = elapsedMs(start);
+            
+            uniform_int_distribution<int> pick(1, side * side);
+            vector<pair<int, int>> pairs(queries);
+            for (auto& pr : pairs) pr = {pick(rng), pick(rng)};
+            double perQuery[2];
+            ShortestPathAlgorithm algorithms[2] = {CUSTOMIZABLE_HIERARCHY, CONTRACTION_HIERARCHY};
+            for (int i = 0; i < 2; ++i) {
+                start = chrono::steady_clock::now();
+                for (const auto& [from, to] : pairs) findRoute(from, to, algorithms[i]);
+                perQuery[i] = elapsedMs(start) * 1000.0 / queries;
+            }
+            
+            // Проверка после переключений ремонта: CCH и CH против Дейкстры на части запросов
+            const int checkedQueries = 50;
+            bool agree = true;
+            for (int q = 0; q < checkedQueries; ++q) {
+                double expected = findRoute(pairs[q].first, pairs[q].second, DIJKSTRA).distance;
+                for (ShortestPathAlgorithm algorithm : algorithms) {
+                    double found = findRoute(pairs[q].first, pairs[q].second, algorithm).distance;
+                    agree = agree && (found == expected || fabs(found - expected) < 1e-6);
+                }
+            }
+            
+            cout << setw(5) << side * side << " | " << setw(14) << fixed << setprecision(1) << prepareTime
+                 << " | " << setw(13) << customizeTime
+                 << " | " << setw(15) << setprecision(3) << toggleTime
+                 << " | " << setw(14) << setprecision(1) << rebuildTime
+                 << " | " << setw(8) << setprecision(2) << perQuery[0] << " | " << setw(7) << perQuery[1]
+                 << " | " << (agree ? "да" : "НЕТ") << endl;
+            
+            swapNetworkState(net);
+        }
+    }
+
+    void benchmarkDistanceMatrix() {
+        const int count = 200;
+        const int samplePairs = 100;
+        const string tempFile = "benchmark_matrix.bin";
+        cout << "\nМатрица расстояний " << count << " x " << count << " (потоков: " << parallelWorkers() << ")\n";
+        cout << "   КС | Попарно (оценка), мс | Матрица, мс | Ускорение | Запись в файл, мс\n";
+        cout << string(80, '-') << endl;
+        
+        for (int side : {30, 100, 200}) {
+            SyntheticNetwork net = generateSyntheticNetwork(side, 17);
+            swapNetworkState(net);
+            getGraph();
+            
+            mt19937 rng(side);
+            uniform_int_distribution<int> pick(1, side * side);
+            vector<int> sourceIds(count), targetIds(count);
+            for (int& id : sourceIds) id = pick(rng);
+            for (int& id : targetIds) id = pick(rng);
+            
+            // Попарный расчет по выборке пар, экстраполированный на всю матрицу
+            auto start = chrono::steady_clock::now();
+            for (int i = 0; i < samplePairs; ++i) {
+                dijkstraShortestPath(sourceIds[i % count], targetIds[(i * 7) % count]);
+            }
+            double pairwiseTime = elapsedMs(start) / samplePairs * count * count;
+            
+            start = chrono::steady_clock::now();
+            distanceMatrix(sourceIds, targetIds);
+            double matrixTime = elapsedMs(start);
+            
+            start = chrono::steady_clock::now();
+            writeDistanceMatrix(sourceIds, targetIds, tempFile);
+            double writeTime = elapsedMs(start);
+            remove(tempFile.c_str());
+            
+            cout << setw(5) << side * side << " | " << setw(20) << fixed << setprecision(1) << pairwiseTime
+                 << " | " << setw(11) << matrixTime
+                 << " | " << setw(8) << setprecision(1) << pairwiseTime / matrixTime << "x"
+                 << " | " << setw(17) << writeTime << endl;
+            
+            swapNetworkState(net);
+        }
+    }
+
+    // Выделения памяти на запрос: findRoute (новый результат на каждый запрос)
+    // против переиспользуемого результата и рабочих областей потока
+    void benchmarkQueryAllocations() {
+        const int queries = 2000;
+        cout << "\nВыделения памяти на запрос кратчайшего пути (" << queries << " запросов)\n";
+        const bool counting = heapAllocationCount() >= 0;
+        if (!counting) {
+            cout << "Подсчет выделений выключен (сборка с -DPIPELINE_COUNT_ALLOCATIONS), выводится только время.\n";
+        }
+        cout << "   КС | Алгоритм        | findRoute: выделений / мкс | Рабочая область: выделений / мкс\n";
+        cout << string(90, '-') << endl;
+        
+        auto allocationsText = [&](long long before, long long after) {
+            ostringstream text;
+            if (counting) text << fixed << setprecision(2) << double(after - before) / queries;
+            else text << "-";
+            return text.str();
+        };
+        
+        for (int side : {30, 100, 200}) {
+            SyntheticNetwork net = generateSyntheticNetwork(side, 19);
+            swapNetworkState(net);
+            const NetworkGraph& g = getGraph();
+            ShortestPathSolver solver(g);
+            
+            mt19937 rng(side);
+            uniform_int_distribution<int> pick(1, side * side);
+            vector<pair<int, int>> pairs(queries);
+            for (auto& pr : pairs) pr = {pick(rng), pick(rng)};
+            
+            ShortestPathAlgorithm algorithms[2] = {DIJKSTRA, BIDIRECTIONAL_DIJKSTRA};
+            const char* names[2] = {"Дейкстра       ", "Двунаправленный"};
+            for (int i = 0; i < 2; ++i) {
+                ShortestPathResult result;
+                auto query = [&](int from, int to) {
+                    if (algorithms[i] == DIJKSTRA) solver.dijkstra(g.nodeIndex(from), g.nodeIndex(to), result);
+                    else solver.bidirectional(g.nodeIndex(from), g.nodeIndex(to), result);
+                };
+                // Прогрев: рабочие области и векторы результата достигают нужного размера
+                for (const auto& [from, to] : pairs) query(from, to);
+                
+                long long allocations = heapAllocationCount();
+                auto start = chrono::steady_clock::now();
+                for (const auto& [from, to] : pairs) findRoute(from, to, algorithms[i]);
+                double routeTime = elapsedMs(start) * 1000.0 / queries;
+                string routeAllocations = allocationsText(allocations, heapAllocationCount());
+                
+                allocations = heapAllocationCount();
+                start = chrono::steady_clock::now();
+                for (const auto& [from, to] : pairs) query(from, to);
+                double reuseTime = elapsedMs(start) * 1000.0 / queries;
+                string reuseAllocations = allocationsText(allocations, heapAllocationCount());
+                
+                cout << setw(5) << side * side << " | " << names[i]
+                     << " | " << setw(15) << routeAllocations
+                     << " / " << setw(8) << fixed << setprecision(1) << routeTime
+                     << " | " << setw(21) << reuseAllocations
+                     << " / " << setw(8) << reuseTime << endl;
+            }
+            
+            swapNetworkState(net);
+        }
+    }
+
+    // Очереди с приоритетом в алгоритме Дейкстры: время запроса и
+    // наибольшее отклонение длины пути от двоичной кучи
+    void benchmarkPriorityQueues() {
+        const int queries = 200;
+        cout << "\nОчереди с приоритетом в алгоритме Дейкстры (" << queries << " запросов), мкс на запрос\n";
+        cout << "   КС | Двоичная куча | 4-арная куча | Поразрядная куча | Отклонение, км\n";
+        cout << string(80, '-') << endl;
+        
+        for (int side : {30, 100, 200, 300}) {
+            SyntheticNetwork net = generateSyntheticNetwork(side, 23);
+            swapNetworkState(net);
+            const NetworkGraph& g = getGraph();
+            ShortestPathSolver solver(g);
+            
+            mt19937 rng(side);
+            uniform_int_distribution<int> pick(0, g.nodeCount() - 1);
+            vector<pair<int, int>> pairs(queries);
+            for (auto& pr : pairs) pr = {pick(rng), pick(rng)};
+            
+            ShortestPathResult result;
+            vector<double> reference(queries);
+            double times[3];
+            double deviation = 0;
+            for (int i = 0; i < 3; ++i) {
+                auto start = chrono::steady_clock::now();
+                for (int q = 0; q < queries; ++q) {
+                    auto [from, to] = pairs[q];
+                    if (i == 0) solver.dijkstra<BinaryHeap>(from, to, result);
+                    else if (i == 1) solver.dijkstra<QuaternaryHeap>(from, to, result);
+                    else solver.dijkstra<RadixHeap>(from, to, result);
+                    if (i == 0) reference[q] = result.distance;
+                    else if (result.distance < ShortestPathSolver::INF) {
+                        deviation = max(deviation, fabs(result.distance - reference[q]));
+                    }
+                }
+                times[i] = elapsedMs(start) * 1000.0 / queries;
+            }
+            
+            cout << setw(5) << side * side << " | " << setw(13) << fixed << setprecision(1) << times[0]
+                 << " | " << setw(12) << times[1] << " | " << setw(16) << times[2]
+                 << " | " << setw(14) << scientific << setprecision(1) << deviation << endl;
+            cout << fixed;
+            
+            swapNetworkState(net);
+        }
+    }
+
+    // Путь наибольшей пропускной способности: Дейкстра против остовного дерева
+    void benchmarkWidestPath() {
+        const int queries = 1000;
+        cout << "\nПуть наибольшей пропускной способности (" << queries << " запросов)\n";
+        cout << "   КС | Дейкстра: мкс | Дерево: построение, мс | Дерево: мкс | Расхождений\n";
+        cout << string(80, '-') << endl;
+        
+        for (int side : {30, 100, 200, 300}) {
+            SyntheticNetwork net = generateSyntheticNetwork(side, 29);
+            swapNetworkState(net);
+            const NetworkGraph& g = getGraph();
+            ShortestPathSolver solver(g);
+            
+            mt19937 rng(side);
+            uniform_int_distribution<int> pick(0, g.nodeCount() - 1);
+            vector<pair<int, int>> pairs(queries);
+            for (auto& pr : pairs) pr = {pick(rng), pick(rng)};
+            
+            WidestPathResult route;
+            vector<double> widths(queries);
+            auto start = chrono::steady_clock::now();
+            for (int q = 0; q < queries; ++q) {
+                solver.widest(pairs[q].first, pairs[q].second, route);
+                widths[q] = route.width;
+            }
+            double dijkstraTime = elapsedMs(start) * 1000.0 / queries;
+            
+            start = chrono::steady_clock::now();
+            const WidestPathTree& tree = getWidestPathTree();
+            double buildTime = elapsedMs(start);
+            
+            int mismatches = 0;
+            start = chrono::steady_clock::now();
+            for (int q = 0; q < queries; ++q) {
+                tree.query(g, pairs[q].first, pairs[q].second, route);
+                if (route.width != widths[q]) mismatches++;
+            }
+            double treeTime = elapsedMs(start) * 1000.0 / queries;
+            
+            cout << setw(5) << side * side << " | " << setw(13) << fixed << setprecision(1) << dijkstraTime
+                 << " | " << setw(22) << setprecision(2) << buildTime
+                 << " | " << setw(11) << treeTime << " | " << setw(11) << mismatches << endl;
+            
+            swapNetworkState(net);
+        }
+    }
+
+    // Многокритериальный поиск: время, размер фронта и доля усеченных поисков
+    // в зависимости от ограничения набора меток вершины
+    void benchmarkParetoRoutes() {
+        const int queries = 50;
+        cout << "\nМногокритериальный поиск маршрутов (" << queries << " запросов, 20% соединений труба-труба)\n";
+        cout << "   КС | Меток на вершину | мс на запрос | Маршрутов | Труба-труба | Меток | Усечено\n";
+        cout << string(94, '-') << endl;
+        
+        for (int side : {30, 100}) {
+            SyntheticNetwork net = generateSyntheticNetwork(side, 31);
+            mt19937 rng(side);
+            for (auto& conn : net.network) {
+                if (rng() % 5 == 0) conn.startType = conn.endType = PIPE_TO_PIPE;
+            }
+            swapNetworkState(net);
+            const NetworkGraph& g = getGraph();
+            ShortestPathSolver solver(g);
+            vector<char> joints = pipeToPipeFlags();
+            
+            // Пары на небольшом удалении: как при выборе маршрута между соседними узлами
+            uniform_int_distribution<int> pick(0, g.nodeCount() - 1);
+            vector<pair<int, int>> pairs(queries);
+            for (auto& pr : pairs) {
+                int from = pick(rng);
+                int r = min(side - 1, (from / side) + 5), c = min(side - 1, (from % side) + 5);
+                pr = {from, g.nodeIndex(r * side + c + 1)};
+            }
+            
+            for (int limit : {4, 16, 64}) {
+                long long routes = 0, labels = 0, routeJoints = 0;
+                int truncated = 0;
+                auto start = chrono::steady_clock::now();
+                for (const auto& [from, to] : pairs) {
+                    ParetoFront front = solver.paretoRoutes(from, to, joints, limit);
+                    routes += front.routes.size();
+                    for (const auto& route : front.routes) routeJoints += route.joints;
+                    labels += front.labels;
+                    truncated += front.truncated;
+                }
+                double perQuery = elapsedMs(start) / queries;
+                
+                cout << setw(5) << side * side << " | " << setw(16) << limit
+                     << " | " << setw(12) << fixed << setprecision(2) << perQuery
+                     << " | " << setw(9) << setprecision(1) << double(routes) / queries
+                     << " | " << setw(11) << (routes > 0 ? double(routeJoints) / routes : 0.0)
+                     << " | " << setw(5) << labels / queries
+                     << " | " << setw(4) << truncated << "/" << queries << endl;
+            }
+            
+            swapNetworkState(net);
+        }
+    }
+
+    // k кратчайших путей: ответвления с деревом кратчайших путей к цели и без него
+    void benchmarkKShortestPaths() {
+        const int queries = 20;
+        const int k = 10;
+        cout << "\nk кратчайших путей, k = " << k << " (" << queries << " запросов), мс на запрос\n";
+        cout << "   КС | Без дерева | С деревом | Ускорение\n";
+        cout << string(50, '-') << endl;
+        
+        for (int side : {30, 100, 200}) {
+            SyntheticNetwork net = generateSyntheticNetwork(side, 37, 3);
+            swapNetworkState(net);
+            const NetworkGraph& g = getGraph();
+            KShortestPathsSolver solver(g);
+            
+            mt19937 rng(side);
+            uniform_int_distribution<int> pick(0, g.nodeCount() - 1);
+            vector<pair<int, int>> pairs(queries);
+            for (auto& pr : pairs) pr = {pick(rng), pick(rng)};
+            
+            double times[2];
+            for (int reuse = 0; reuse < 2; ++reuse) {
+                auto start = chrono::steady_clock::now();
+                for (const auto& [from, to] : pairs) solver.run(from, to, k, reuse);
+                times[reuse] = elapsedMs(start) / queries;
+            }
+            
+            cout << setw(5) << side * side << " | " << setw(10) << fixed << setprecision(2) << times[0]
+                 << " | " << setw(9) << times[1] << " | " << setw(8) << setprecision(1) << times[0] / times[1] << "x" << endl;
+            
+            swapNetworkState(net);
+        }
+    }
+
+    // Пары маршрутов без общих труб: потенциалы источника из кэша и пересчет на каждый запрос
+    void benchmarkDisjointRoutes() {
+        const int sources = 4;
+        const int targetsPerSource = 25;
+        cout << "\nПары маршрутов без общих труб (" << sources << " источника по "
+             << targetsPerSource << " запросов), мс на запрос\n";
+        cout << "   КС | Без кэша | С кэшем | Ускорение\n";
+        cout << string(46, '-') << endl;
+        
+        for (int side : {30, 100, 200}) {
+            SyntheticNetwork net = generateSyntheticNetwork(side, 41, 3);
+            swapNetworkState(net);
+            const NetworkGraph& g = getGraph();
+            ShortestPathSolver solver(g);
+            
+            mt19937 rng(side);
+            uniform_int_distribution<int> pick(0, g.nodeCount() - 1);
+            vector<pair<int, int>> pairs;
+            for (int s = 0; s < sources; ++s) {
+                int from = pick(rng);
+                for (int q = 0; q < targetsPerSource; ++q) pairs.push_back({from, pick(rng)});
+            }
+            
+            double checksum[2] = {0, 0};
+            double times[2];
+            auto start = chrono::steady_clock::now();
+            for (const auto& [from, to] : pairs) {
+                checksum[0] += solver.disjointPair(from, to, solver.shortestPathTree(from)).settled;
+            }
+            times[0] = elapsedMs(start) / pairs.size();
+            
+            start = chrono::steady_clock::now();
+            for (const auto& [from, to] : pairs) {
+                checksum[1] += solver.disjointPair(from, to, getSourcePotentials(from)).settled;
+            }
+            times[1] = elapsedMs(start) / pairs.size();
+            
+            cout << right << setw(5) << side * side << " | " << setw(8) << fixed << setprecision(3) << times[0]
+                 << " | " << setw(7) << times[1] << " | " << setw(8) << setprecision(1)
+                 << times[0] / times[1] << "x" << left << endl;
+            if (checksum[0] != checksum[1]) cout << "Внимание: результаты с кэшем отличаются!\n";
+            
+            swapNetworkState(net);
+        }
+    }
+
+    // Мосты и точки сочленения: сетка с частью труб в ремонте и "змейка" -
+    // единственный путь через все КС (глубина обхода равна числу КС)
+    void benchmarkCriticalElements() {
+        cout << "\nКритические трубы и объекты (обход без рекурсии)\n";
+        cout << "     КС | Сеть   |  Время, мс | Мостов | Точек сочл. | Глубина\n";
+        cout << string(66, '-') << endl;
+        
+        for (int side : {100, 300, 700}) {
+            SyntheticNetwork net = generateSyntheticNetwork(side, 43);
+            swapNetworkState(net);
+            
+            for (int layout = 0; layout < 2; ++layout) {
+                mt19937 rng(side);
+                // В "змейке" у каждой КС не больше одной трубы вправо и одной вниз,
+                // параллельные дубли и хорды в ремонте
+                vector<char> rightTaken(side * side, 0), downTaken(side * side, 0);
+                for (auto& pipe : pipes) {
+                    int a = min(pipe.startId, pipe.endId) - 1, b = max(pipe.startId, pipe.endId) - 1;
+                    bool inService;
+                    if (layout == 0) {
+                        inService = rng() % 100 >= 40;
+                    } else if (b - a == 1 && a / side == b / side) {
+                        inService = !rightTaken[a];
+                        rightTaken[a] = 1;
+                    } else if (b - a == side && a % side == ((a / side) % 2 == 0 ? side - 1 : 0)) {
+                        // Переход на следующий ряд попеременно у правого и левого края
+                        inService = !downTaken[a];
+                        downTaken[a] = 1;
+                    } else {
+                        inService = false;
+                    }
+                    pipe.underRepair = !inService;
+                }
+                markNetworkChanged();
+                const NetworkGraph& g = getGraph();
+                
+                auto start = chrono::steady_clock::now();
+                CriticalElementsResult result = CriticalElementsAnalyzer::analyze(g);
+                double elapsed = elapsedMs(start);
+                
+                cout << right << setw(7) << side * side << " | " << (layout == 0 ? "сетка " : "змейка")
+                     << " | " << setw(10) << fixed << setprecision(2) << elapsed << " | " << setw(6)
+                     << result.bridges.size() << " | " << setw(11) << result.articulationPoints.size()
+                     << " | " << setw(7) << result.maxDepth << left << endl;
+            }
+            
+            swapNetworkState(net);
+        }
+    }
+
+    // Анализ отказов N-1: расчет с нуля для каждой трубы против пропуска труб
+    // без потока и дорасчета от исходного решения
+    void benchmarkPipeOutages() {
+        cout << "\nАнализ отказов труб N-1 (источник и сток - противоположные углы сетки), потоков: "
+             << parallelWorkers() << "\n";
+        cout << "   КС | Труб | Рассчитано | С нуля, мс | Дорасчет, мс | Ускорение\n";
+        cout << string(68, '-') << endl;
+        
+        for (int side : {10, 20, 30}) {
+            SyntheticNetwork net = generateSyntheticNetwork(side, 47, 3);
+            swapNetworkState(net);
+            const NetworkGraph& g = getGraph();
+            int source = g.nodeIndex(1);
+            int sink = g.nodeIndex(side * side);
+            
+            // Без пропуска: каждая работающая труба, поток считается заново
+            auto start = chrono::steady_clock::now();
+            vector<unique_ptr<NetworkGraph>> copies(parallelWorkers());
+            parallelFor(pipes.size(), [&](int worker, int i) {
+                if (!copies[worker]) copies[worker].reset(new NetworkGraph(g));
+                NetworkGraph& local = *copies[worker];
+                const GraphEdge& e = g.arc(g.forwardArc(pipes[i].id));
+                local.applyDelta({ARC_UPDATED, pipes[i].id, 0, 0, 0.0, e.weight}, g.getVersion());
+                MaxFlowSolver(local, source, sink).run(DINIC);
+                local.applyDelta({ARC_UPDATED, pipes[i].id, 0, 0, e.capacity, e.weight}, g.getVersion());
+            }, 1);
+            double cold = elapsedMs(start);
+            
+            start = chrono::steady_clock::now();
+            ContingencyResult result = ContingencyAnalyzer::run(g, source, sink);
+            double warm = elapsedMs(start);
+            
+            cout << right << setw(5) << side * side << " | " << setw(4) << pipes.size() << " | "
+                 << setw(10) << result.outages.size() << " | " << setw(10) << fixed << setprecision(1) << cold
+                 << " | " << setw(12) << warm << " | " << setw(8) << cold / warm << "x" << left << endl;
+            
+            swapNetworkState(net);
+        }
+    }
+
+    // Дерево Гомори-Ху: построение (пакеты по одному и по числу потоков) и запросы
+    // по дереву против отдельного расчета потока Диницем на каждую пару
+    void benchmarkGomoryHu() {
+        const int queries = 200;
+        cout << "\nДерево Гомори-Ху, потоков: " << parallelWorkers() << ", запросов: " << queries << "\n";
+        cout << "   КС | Построение, мс | Пакетное, мс | Разрезов | Запрос, мкс | Диниц, мкс\n";
+        cout << string(76, '-') << endl;
+        
+        for (int side : {10, 20, 30}) {
+            SyntheticNetwork net = generateSyntheticNetwork(side, 53, 3);
+            swapNetworkState(net);
+            const NetworkGraph& g = getGraph();
+            
+            GomoryHuTree tree;
+            auto start = chrono::steady_clock::now();
+            tree.build(g, 1);
+            double sequential = elapsedMs(start);
+            
+            int batch = max(2, 2 * parallelWorkers());
+            start = chrono::steady_clock::now();
+            tree.build(g, batch);
+            double batched = elapsedMs(start);
+            
+            mt19937 rng(side);
+            uniform_int_distribution<int> pick(0, g.nodeCount() - 1);
+            vector<pair<int, int>> pairs(queries);
+            for (auto& pr : pairs) {
+                pr = {pick(rng), pick(rng)};
+                if (pr.first == pr.second) pr.second = (pr.second + 1) % g.nodeCount();
+            }
+            
+            double checksum[2] = {0, 0};
+            start = chrono::steady_clock::now();
+            for (const auto& [from, to] : pairs) checksum[0] += tree.query(from, to);
+            double treeQuery = elapsedMs(start) * 1000 / queries;
+            
+            NetworkGraph undirected = g;
+            undirected.makeUndirected();
+            start = chrono::steady_clock::now();
+            for (const auto& [from, to] : pairs) checksum[1] += MaxFlowSolver(undirected, from, to).run(DINIC).value;
+            double dinicQuery = elapsedMs(start) * 1000 / queries;
+            
+            cout << right << setw(5) << side * side << " | " << setw(14) << fixed << setprecision(1) << sequential
+                 << " | " << setw(12) << batched << " | " << setw(8) << tree.getCutsComputed()
+                 << " | " << setw(11) << setprecision(2) << treeQuery << " | " << setw(10) << dinicQuery << left << endl;
+            if (fabs(checksum[0] - checksum[1]) > 1e-6 * max(1.0, checksum[1])) {
+                cout << "Внимание: потоки по дереву отличаются от расчета Диницем!\n";
+            }
+            
+            swapNetworkState(net);
+        }
+    }
+
+    // Поток минимальной стоимости: последовательные кратчайшие пути против
+    // масштабирования стоимостей (максимальный объем между углами сетки)
+    void benchmarkMinCostFlow() {
+        cout << "\nПоток минимальной стоимости (максимальный объем между углами сетки)\n";
+        cout << "   КС |  Объем | Пути, мс | Путей | Масштаб., мс | Фаз | Разница стоимости\n";
+        cout << string(78, '-') << endl;
+        
+        for (int side : {10, 30, 60, 100}) {
+            SyntheticNetwork net = generateSyntheticNetwork(side, 59, 3);
+            swapNetworkState(net);
+            const NetworkGraph& g = getGraph();
+            int source = g.nodeIndex(1);
+            int sink = g.nodeIndex(side * side);
+            const double demand = numeric_limits<double>::infinity();
+            
+            auto start = chrono::steady_clock::now();
+            MinCostFlowResult paths = MinCostFlowSolver(g, source, sink).run(SUCCESSIVE_SHORTEST_PATHS, demand);
+            double pathsTime = elapsedMs(start);
+            
+            start = chrono::steady_clock::now();
+            MinCostFlowResult scaling = MinCostFlowSolver(g, source, sink).run(COST_SCALING, demand);
+            double scalingTime = elapsedMs(start);
+            
+            cout << right << setw(5) << side * side << " | " << setw(6) << fixed << setprecision(2) << paths.value
+                 << " | " << setw(8) << setprecision(1) << pathsTime << " | " << setw(5) << paths.iterations
+                 << " | " << setw(12) << scalingTime << " | " << setw(3) << scaling.iterations << " | "
+                 << setw(16) << setprecision(4) << fabs(paths.cost - scaling.cost) / max(1.0, paths.cost) * 100
+                 << "%" << left << endl;
+            
+            swapNetworkState(net);
+        }
+    }
+
+    // Многие источники и потребители: один расчет потока через сверхисточник
+    // и сверхсток при тысячах КС с балансом
+    void benchmarkSupplyDemand() {
+        cout << "\nДопустимость поставок (10% КС - источники, 20% - потребители)\n";
+        cout << "    КС | Терминалов | Отбор  | Доставлено | Потребителей с недопоставкой | Время, мс\n";
+        cout << string(88, '-') << endl;
+        
+        for (int side : {30, 100, 200}) {
+            SyntheticNetwork net = generateSyntheticNetwork(side, 61, 3);
+            swapNetworkState(net);
+            const NetworkGraph& g = getGraph();
+            
+            mt19937 rng(side);
+            uniform_real_distribution<double> amount(0.001, 0.01);
+            vector<pair<int, double>> balances;
+            for (const auto& station : stations) {
+                int roll = rng() % 10;
+                if (roll == 0) balances.push_back({station.id, 2 * amount(rng)});
+                else if (roll <= 2) balances.push_back({station.id, -amount(rng)});
+            }
+            
+            auto start = chrono::steady_clock::now();
+            SupplyDemandResult result = SupplyDemandSolver::solve(g, balances);
+            double elapsed = elapsedMs(start);
+            
+            cout << right << setw(6) << side * side << " | " << setw(10) << balances.size() << " | "
+                 << setw(6) << fixed << setprecision(2) << result.totalDemand << " | " << setw(10)
+                 << result.delivered << " | " << setw(28) << result.unmetDemand.size() << " | "
+                 << setw(9) << setprecision(1) << elapsed << left << endl;
+            
+            swapNetworkState(net);
+        }
+    }
+
+    // Гидравлический расчет на сетках до 100 тыс. КС: первый расчет с анализом
+    // портрета и повторный после изменения диаметров части труб
+    void benchmarkHydraulics() {
+        cout << "\nГидравлический расчет (1% КС - источники 7.5 МПа, 30% - потребители)\n";
+        cout << "     КС | Ненулевых L | Итераций | Анализ, мс | Разлож., мс | Всего, мс | Повторно, мс\n";
+        cout << string(90, '-') << endl;
+        
+        for (int side : {100, 200, 316}) {
+            SyntheticNetwork net = generateSyntheticNetwork(side, 67, 3);
+            swapNetworkState(net);
+            mt19937 rng(side);
+            uniform_real_distribution<double> demand(0.02, 0.06);
+            for (auto& station : stations) {
+                int roll = rng() % 100;
+                station.balance = roll == 0 ? 1.0 : roll <= 30 ? -demand(rng) : 0.0;
+            }
+            getGraph();
+            hydraulicSolver = HydraulicSolver();
+            
+            auto start = chrono::steady_clock::now();
+            HydraulicResult first = solveHydraulics(7.5);
+            double total = elapsedMs(start);
+            
+            // Новые диаметры 5% труб: структура та же, портрет разложения используется повторно
+            for (auto& pipe : pipes) {
+                if (rng() % 20 == 0) pipe.diameter = PIPE_CAPACITIES[rng() % PIPE_CAPACITIES.size()].diameter;
+            }
+            markNetworkChanged();
+            getGraph();
+            start = chrono::steady_clock::now();
+            HydraulicResult second = solveHydraulics(7.5);
+            double repeated = elapsedMs(start);
+            
+            cout << right << setw(7) << side * side << " | " << setw(11) << first.factorNonzeros << " | "
+                 << setw(8) << first.iterations << " | " << setw(10) << fixed << setprecision(1) << first.analyzeMs
+                 << " | " << setw(11) << first.factorMs << " | " << setw(9) << total << " | " << setw(12)
+                 << repeated << left << endl;
+            if (!first.converged || !second.converged || !second.symbolicReused) {
+                cout << "Внимание: расчет не сошелся или портрет не использован повторно!\n";
+            }
+            
+            swapNetworkState(net);
+        }
+        hydraulicSolver = HydraulicSolver();
+    }
+
+    // Нестационарный расчет за сутки: время шага по всем трубам, запись раз в час
+    void benchmarkTransient() {
+        const string tempFile = "benchmark_transient.bin";
+        cout << "\nНестационарный расчет за сутки (1% КС - граничные, 30% - потребители)\n";
+        cout << "     Труб | Подшагов/мин | Всего, мс | Шаг, мкс | Трубо-шагов/с | Файл, МБ\n";
+        cout << string(80, '-') << endl;
+        
+        for (int side : {50, 100, 200}) {
+            SyntheticNetwork net = generateSyntheticNetwork(side, 71, 3);
+            swapNetworkState(net);
+            mt19937 rng(side);
+            uniform_real_distribution<double> demand(0.02, 0.06);
+            for (auto& station : stations) {
+                int roll = rng() % 100;
+                station.activeWorkshops = roll == 0 ? station.totalWorkshops : 0;
+                station.balance = roll >= 1 && roll <= 30 ? -demand(rng) : 0.0;
+            }
+            
+            ofstream file(tempFile, ios::binary);
+            auto start = chrono::steady_clock::now();
+            TransientResult result = simulateTransient(7.5, 60, file);
+            double total = elapsedMs(start);
+            double megabytes = file.tellp() / 1048576.0;
+            file.close();
+            remove(tempFile.c_str());
+            
+            double steps = static_cast<double>(TransientSimulator::HORIZON_MINUTES) * result.substeps;
+            cout << right << setw(9) << result.pipes << " | " << setw(12) << result.substeps << " | "
+                 << setw(9) << fixed << setprecision(1) << total << " | " << setw(8) << total * 1000 / steps
+                 << " | " << setw(13) << scientific << setprecision(2) << result.pipes * steps / (total / 1000)
+                 << fixed << " | " << setw(8) << setprecision(1) << megabytes << left << endl;
+            
+            swapNetworkState(net);
+        }
+    }
+
+    void runBenchmarks() {
+        cout << "\nТесты производительности\n"
+             << "1. Поиск объектов по ID\n2. Алгоритмы максимального потока\n"
+             << "3. Инкрементальный пересчет потока\n4. Алгоритмы кратчайшего пути\n"
+             << "5. Иерархия сжатия\n6. Настраиваемая иерархия сжатия\n7. Матрица расстояний\n"
+             << "8. Выделения памяти на запрос\n9. Очереди с приоритетом\n"
+             << "10. Путь наибольшей пропускной способности\n11. Многокритериальный поиск маршрутов\n"
+             << "12. k кратчайших путей\n13. Пары маршрутов без общих труб\n"
+             << "14. Критические трубы и объекты\n15. Анализ отказов труб N-1\n"
+             << "16. Дерево Гомори-Ху\n17. Поток минимальной стоимости\n"
+             << "18. Многие источники и потребители\n19. Гидравлический расчет\n"
+             << "20. Нестационарный расчет за сутки\n0. Назад\n";
+        int choice = InputValidator::getIntInput("Выберите тест: ", 0, 20);
+        
+        switch (choice) {
+            case 1: benchmarkIdLookup(); break;
+            case 2: benchmarkMaxFlow(); break;
+            case 3: benchmarkIncrementalMaxFlow(); break;
+            case 4: benchmarkShortestPath(); break;
+            case 5: benchmarkContractionHierarchy(); break;
+            case 6: benchmarkCustomizableHierarchy(); break;
+            case 7: benchmarkDistanceMatrix(); break;
+            case 8: benchmarkQueryAllocations(); break;
+            case 9: benchmarkPriorityQueues(); break;
+            case 10: benchmarkWidestPath(); break;
+            case 11: benchmarkParetoRoutes(); break;
+            case 12: benchmarkKShortestPaths(); break;
+            case 13: benchmarkDisjointRoutes(); break;
+            case 14: benchmarkCriticalElements(); break;
+            case 15: benchmarkPipeOutages(); break;
+            case 16: benchmarkGomoryHu(); break;
+            case 17: benchmarkMinCostFlow(); break;
+            case 18: benchmarkSupplyDemand(); break;
+            case 19: benchmarkHydraulics(); break;
+            case 20: benchmarkTransient(); break;
+            case 0: return;
+        }
+        logger.log("Тест производительности", "Тест: " + to_string(choice));
+    }
+
     void run() {
         logger.log("Запуск программы");
         
@@ -1724,9 +8257,21 @@ public:
                  << "12. Поиск труб\n13. Поиск КС\n14. Сохранить данные\n15. Загрузить данные\n"
                  << "16. Соединить объекты (создать сеть)\n17. Отключить трубу от сети\n"
                  << "18. Просмотр сети\n19. Топологическая сортировка КС\n"
-                 << "20. Расчет кратчайшего пути между КС\n21. Расчет максимального потока между КС\n0. Выход\n";
+                 << "20. Расчет кратчайшего пути между КС\n21. Расчет максимального потока между КС\n"
+                 << "22. Тесты производительности\n23. Матрица расстояний между КС\n"
+                 << "24. Путь наибольшей пропускной способности между КС\n"
+                 << "25. Многокритериальный поиск маршрутов между КС\n"
+                 << "26. Альтернативные маршруты между КС (k кратчайших)\n"
+                 << "27. Пара маршрутов без общих труб между КС\n"
+                 << "28. Критические трубы и КС (мосты и точки сочленения)\n"
+                 << "29. Анализ отказов труб (N-1) для потока между КС\n"
+                 << "30. Максимальный поток между парами КС (дерево Гомори-Ху)\n"
+                 << "31. Поставка между КС с минимальной стоимостью\n"
+                 << "32. Баланс поставок: все источники и потребители КС\n"
+                 << "33. Гидравлический расчет установившегося режима\n"
+                 << "34. Нестационарный режим за сутки (запись в файл)\n0. Выход\n";
             
-            int choice = InputValidator::getIntInput("Выберите действие: ", 0, 21);
+            int choice = InputValidator::getIntInput("Выберите действие: ", 0, 34);
             logger.log("Выбор меню", "Действие: " + to_string(choice));
             
             switch (choice) {
@@ -1751,6 +8296,19 @@ public:
                 case 19: topologicalSort(); break;
                 case 20: findShortestPath(); break;
                 case 21: calculateMaxFlow(); break;
+                case 22: runBenchmarks(); break;
+                case 23: calculateDistanceMatrix(); break;
+                case 24: findWidestPath(); break;
+                case 25: findParetoRoutes(); break;
+                case 26: findAlternativeRoutes(); break;
+                case 27: findDisjointRoutes(); break;
+                case 28: findCriticalElements(); break;
+                case 29: analyzePipeOutages(); break;
+                case 30: queryPairMaxFlows(); break;
+                case 31: calculateMinCostFlow(); break;
+                case 32: checkSupplyDemand(); break;
+                case 33: calculateHydraulics(); break;
+                case 34: runTransientSimulation(); break;
                 case 0:
                     cout << "Выход из программы.\n";
                     logger.log("Выход из программы");